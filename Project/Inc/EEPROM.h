@@ -9,6 +9,30 @@
 
 #include "stm32f4xx_hal.h"
 
+// EEPROM address range
+constexpr uint16_t EEPROM_MIN_ADDRESS = 0x0000;
+constexpr uint16_t EEPROM_MAX_ADDRESS = 0x7FFF;
+
+// EEPROM page size (page writes must not cross a page boundary)
+constexpr uint16_t EEPROM_PAGE_SIZE = 64;
+
+// EEPROM capacity in bytes
+constexpr uint32_t EEPROM_SIZE = EEPROM_MAX_ADDRESS - EEPROM_MIN_ADDRESS + 1;
+
+// Write cycle histogram (500 us bins, the last bin collects everything from 5 ms upwards)
+constexpr uint32_t EEPROM_WRITE_CYCLE_HISTOGRAM_BIN_US = 500;
+constexpr size_t EEPROM_WRITE_CYCLE_HISTOGRAM_BINS = 11;
+
+// Measured write cycle times, collected by ACK polling
+struct EEPROMWriteCycleStats
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t total_us;
+    uint32_t histogram[EEPROM_WRITE_CYCLE_HISTOGRAM_BINS];
+};
+
 class EEPROM
 {
 public:
@@ -16,15 +40,29 @@ public:
     EEPROM(I2C_HandleTypeDef *i2c_handle, uint8_t i2c_address);
 
     // Public methods
+    uint8_t getI2CAddress();
     uint16_t getCurrentWriteAddress();
     void buildWriteBuffer(uint8_t *buffer, uint16_t data);
     void buildAddressBuffer(uint8_t *buffer, uint16_t memory_address);
     HAL_StatusTypeDef writeTwoBytes(uint16_t data);
     HAL_StatusTypeDef readTwoBytes(uint16_t memory_address, uint16_t *data);
+    HAL_StatusTypeDef writePage(uint16_t memory_address, const uint8_t *data, uint16_t length);
+    HAL_StatusTypeDef readRange(uint16_t start_address, uint8_t *buffer, uint16_t length);
+    bool isWriteComplete();
+    HAL_StatusTypeDef waitForWriteComplete(uint32_t timeout_ms);
+    const EEPROMWriteCycleStats &getWriteCycleStats();
+    void startWriteCycle();
 
 private:
+    // Private helper methods
+    HAL_StatusTypeDef readSequential(uint16_t start_address, uint8_t *buffer, uint16_t length);
+    void recordWriteCycleTime(uint32_t write_cycle_us);
+
     // Data members
     I2C_HandleTypeDef *i2c_handle;
     uint8_t i2c_address;
     uint16_t current_write_address;
+    bool write_in_progress;
+    uint32_t write_cycle_start_cycles;
+    EEPROMWriteCycleStats write_cycle_stats;
 };
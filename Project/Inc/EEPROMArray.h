@@ -0,0 +1,40 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file EEPROMArray.h
+ * @brief Header file for the EEPROMArray class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#include "EEPROM.h"
+
+// Maximum number of 24FC256 chips on one bus (A0-A2 select addresses 0x50 to 0x57)
+constexpr uint8_t EEPROM_ARRAY_MAX_CHIPS = 8;
+
+// Number of pages per chip
+constexpr uint16_t EEPROM_PAGES_PER_CHIP = EEPROM_SIZE / EEPROM_PAGE_SIZE;
+
+class EEPROMArray
+{
+public:
+    // Constructor
+    EEPROMArray(EEPROM *const *chips, uint8_t chip_count);
+
+    // Public methods
+    uint8_t getChipCount();
+    EEPROM *getChip(uint8_t chip_index);
+    uint16_t getPageCount();
+    uint32_t getSize();
+    EEPROM *getChipForPage(uint16_t page_index);
+    uint16_t getChipAddressForPage(uint16_t page_index);
+    HAL_StatusTypeDef writePage(uint16_t page_index, const uint8_t *data, uint16_t length);
+    HAL_StatusTypeDef readPage(uint16_t page_index, uint8_t *buffer, uint16_t length);
+
+private:
+    // Data members
+    EEPROM *chips[EEPROM_ARRAY_MAX_CHIPS];
+    uint8_t chip_count;
+};
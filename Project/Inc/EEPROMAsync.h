@@ -0,0 +1,84 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file EEPROMAsync.h
+ * @brief Header file for the EEPROMAsync class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#include "EEPROM.h"
+
+// Maximum number of page writes waiting for the bus
+constexpr uint8_t EEPROM_ASYNC_QUEUE_SIZE = 4;
+
+// Number of times a page write whose transfer failed is sent again before it is reported as failed
+constexpr uint8_t EEPROM_ASYNC_MAX_RETRIES = 2;
+
+// Called from EEPROMAsync::service once a page write has completed (including its write cycle) or
+// failed on every attempt
+typedef void (*EEPROMWriteCompleteCallback)(EEPROM *eeprom, uint16_t memory_address, HAL_StatusTypeDef status, void *context);
+
+class EEPROMAsync
+{
+public:
+    // Constructor
+    EEPROMAsync(I2C_HandleTypeDef *i2c_handle);
+
+    // Public methods
+    void setCompletionCallback(EEPROMWriteCompleteCallback callback, void *context);
+    HAL_StatusTypeDef submitPageWrite(EEPROM *eeprom, uint16_t memory_address, const uint8_t *data, uint16_t length);
+    void service();
+    bool isIdle();
+    bool isTransferInProgress();
+    uint8_t getPendingCount();
+    HAL_StatusTypeDef waitForTransferComplete(uint32_t timeout_ms);
+    HAL_StatusTypeDef waitUntilIdle(uint32_t timeout_ms);
+
+    // Interrupt handlers (called from the HAL I2C callbacks)
+    void handleTransferComplete();
+    void handleTransferError();
+
+    // Static methods
+    static EEPROMAsync *getInstance(I2C_HandleTypeDef *i2c_handle);
+
+private:
+    // Request life cycle
+    enum class State : uint8_t
+    {
+        Queued,
+        Transferring,
+        TransferError,
+        WriteCycle
+    };
+
+    // Queued page write, stored with its two address bytes so it can be sent as one DMA transfer
+    struct WriteRequest
+    {
+        EEPROM *eeprom;
+        uint16_t memory_address;
+        uint16_t length;
+        volatile State state;
+        uint8_t retry_count;
+        uint8_t buffer[2 + EEPROM_PAGE_SIZE];
+    };
+
+    // Private helper methods
+    HAL_StatusTypeDef startTransfer(uint8_t queue_index);
+    void completeRequest(HAL_StatusTypeDef status);
+
+    // Data members
+    I2C_HandleTypeDef *i2c_handle;
+    WriteRequest queue[EEPROM_ASYNC_QUEUE_SIZE];
+    uint8_t queue_head;
+    uint8_t queue_count;
+    volatile bool transfer_in_progress;
+    uint8_t transfer_index;
+    EEPROMWriteCompleteCallback completion_callback;
+    void *completion_context;
+
+    // Static members
+    static EEPROMAsync *instances[3];
+};
@@ -0,0 +1,182 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file EEPROMLog.h
+ * @brief Header file for the EEPROMLog class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#include "EEPROM.h"
+#include "EEPROMArray.h"
+#include "EEPROMAsync.h"
+#include "project_codec.h"
+
+// Log record layout: one record per EEPROM page, with consecutive records striped across the chips of an EEPROMArray
+//   Byte 0      Header marker (0xA_) and sample format (low nibble)
+//   Byte 1      Number of samples in the record
+//   Bytes 2-3   Sequence stamp (big-endian), incremented by one per record
+//   Bytes 4-5   CRC-16/CCITT-FALSE (big-endian) over bytes 0-3 and the used part of the payload
+//   Bytes 6-63  Payload
+// The overhead is 6 bytes per 64-byte record (9.4%).
+// Records of several sensors are tagged: their marker is 0xB_ and byte 6 holds the sensor mask (bit n
+// set for the TMP100 at address 0x48 + n), followed by a 57-byte payload. The payload holds whole
+// scans, one sample per sensor in ascending address order, and the CRC also covers the sensor mask.
+constexpr uint16_t LOG_RECORD_SIZE = EEPROM_PAGE_SIZE;
+constexpr uint16_t LOG_RECORD_HEADER_SIZE = 6;
+constexpr uint16_t LOG_RECORD_PAYLOAD_SIZE = LOG_RECORD_SIZE - LOG_RECORD_HEADER_SIZE;
+constexpr uint16_t LOG_RECORD_SENSOR_TAG_SIZE = 1;
+
+// Sample formats: the upper two bits select the encoding, the lower two bits hold the TMP100
+// resolution bits (R1 R0) the samples were taken at
+// Capacities are given per 24FC256 (512 records) and scale with the number of chips.
+//   RAW16     Raw 16-bit register values, 29 samples per record (14848 in the 24FC256)
+//   PACKED    Only the (9 + R1R0) significant bits of each sample, packed across byte boundaries:
+//             51/46/42/38 samples per record at 9/10/11/12-bit resolution (26112 to 19456 in the 24FC256)
+//   DELTA     Delta stream of the significant bits (see project_codec.h): the first sample is a
+//             keyframe, so every record decodes on its own. Slowly changing temperatures take about
+//             half a bit to four bits per sample, up to 255 samples per record (130560 in the 24FC256)
+constexpr uint8_t LOG_FORMAT_RAW16 = 0x00;
+constexpr uint8_t LOG_FORMAT_PACKED = 0x04;
+constexpr uint8_t LOG_FORMAT_DELTA = 0x08;
+constexpr uint8_t LOG_FORMAT_ENCODING_MASK = 0x0C;
+constexpr uint8_t LOG_FORMAT_RESOLUTION_MASK = 0x03;
+
+// Largest number of samples in a record of any format (delta records, limited by the sample count byte)
+constexpr uint8_t LOG_RECORD_MAX_SAMPLES = 255;
+
+// Largest number of sensors in a tagged record, one per TMP100 address
+constexpr uint8_t LOG_MAX_SENSORS = 8;
+
+// Decoded log record
+struct LogRecord
+{
+    uint16_t record_index;
+    uint16_t sequence;
+    uint8_t format;
+    uint8_t sensor_mask;
+    uint8_t sample_count;
+    uint8_t payload[LOG_RECORD_PAYLOAD_SIZE];
+};
+
+// Results of a pass over all records
+struct LogScanResult
+{
+    uint16_t valid_record_count;
+    uint16_t corrupt_record_count;
+    uint16_t empty_record_count;
+};
+
+// Background verification of the records written to the EEPROM
+//   Off            No verification
+//   PerPage        Each committed page is read back once and its CRC compared with the RAM copy
+//   PeriodicScrub  One stored record per slot is read and checked against its CRC, cycling through the log
+enum class LogVerifyPolicy : uint8_t
+{
+    Off,
+    PerPage,
+    PeriodicScrub
+};
+
+// Results of the background verification since construction
+struct LogHealthCounters
+{
+    uint32_t verified_page_count;
+    uint32_t failed_page_count;
+    uint32_t read_error_count;
+    uint32_t scrub_pass_count;
+    uint32_t write_error_count;
+};
+
+// Called once per valid record, oldest record first
+typedef void (*LogRecordCallback)(const LogRecord &record, void *context);
+
+class EEPROMLog
+{
+public:
+    // Constructor
+    EEPROMLog(EEPROMArray *eeprom_array);
+
+    // Public methods
+    void setAsyncWriter(EEPROMAsync *async_writer);
+    void setWriteResultCallback(EEPROMWriteCompleteCallback callback, void *context);
+    HAL_StatusTypeDef setSampleFormat(uint8_t format);
+    uint8_t getSampleFormat();
+    HAL_StatusTypeDef setSensorMask(uint8_t sensor_mask);
+    uint8_t getSensorMask();
+    HAL_StatusTypeDef recoverHead();
+    uint16_t getRecordCount();
+    uint32_t getCurrentWriteAddress();
+    uint16_t getCurrentRecordIndex();
+    uint8_t getCurrentSampleCount();
+    uint16_t getCurrentSequence();
+    HAL_StatusTypeDef appendSample(uint16_t sample);
+    HAL_StatusTypeDef appendScan(const uint16_t *samples);
+    HAL_StatusTypeDef flush();
+    HAL_StatusTypeDef readSample(uint16_t record_index, uint8_t sample_index, uint16_t *sample);
+    HAL_StatusTypeDef readRecord(uint16_t record_index, LogRecord *record);
+    uint8_t decodeSamples(const LogRecord &record, uint16_t *samples);
+    void setVerifyPolicy(LogVerifyPolicy policy);
+    HAL_StatusTypeDef runVerificationSlot();
+    const LogHealthCounters &getHealthCounters();
+    HAL_StatusTypeDef scanRecords(LogRecordCallback callback, void *context, LogScanResult *result);
+
+private:
+    // Private helper methods
+    HAL_StatusTypeDef readRecordHeader(uint16_t record_index, uint8_t *header);
+    HAL_StatusTypeDef checkNewestPassRecord(uint16_t record_index, uint16_t first_sequence, bool *is_newest_pass);
+    bool isFormatValid(uint8_t format);
+    uint8_t getSampleBitWidth(uint8_t format);
+    uint8_t getScanLength(uint8_t sensor_mask);
+    uint8_t getPayloadOffset(uint8_t sensor_mask);
+    uint16_t getPayloadBits(uint8_t sensor_mask);
+    uint8_t getRecordSensorMask(const uint8_t *record);
+    uint8_t getMaxSampleCount(uint8_t format, uint8_t sensor_mask);
+    uint16_t getPayloadLength(const uint8_t *record);
+    bool isRecordFull();
+    void encodeSample(uint8_t format, uint8_t sensor_mask, uint8_t *payload, uint8_t sample_index, uint16_t sample);
+    uint16_t decodeSample(uint8_t format, uint8_t sensor_mask, const uint8_t *payload, uint8_t sample_index);
+    bool isRecordHeaderValid(const uint8_t *header);
+    uint16_t getRecordSequence(const uint8_t *header);
+    uint16_t calculateRecordCRC(const uint8_t *record);
+    bool isRecordIntact(const uint8_t *record);
+    bool decodeRecord(uint16_t record_index, const uint8_t *buffer, LogRecord *record);
+    HAL_StatusTypeDef waitForPendingWrites();
+    HAL_StatusTypeDef verifyCommittedPage();
+    HAL_StatusTypeDef scrubNextRecord();
+    HAL_StatusTypeDef commitRecord();
+    HAL_StatusTypeDef retainClosedRecord();
+    void startRecord(uint16_t record_index, uint16_t sequence);
+    bool isRecordPage(uint16_t record_index, EEPROM *eeprom, uint16_t memory_address);
+    void handleWriteResult(EEPROM *eeprom, uint16_t memory_address, HAL_StatusTypeDef status);
+    static void handleAsyncWriteResult(EEPROM *eeprom, uint16_t memory_address, HAL_StatusTypeDef status, void *context);
+
+    // Data members
+    EEPROMArray *eeprom_array;
+    EEPROMAsync *async_writer;
+    EEPROMWriteCompleteCallback write_result_callback;
+    void *write_result_context;
+    uint16_t record_count;
+    uint8_t record_buffer[LOG_RECORD_SIZE];
+    uint16_t record_index;
+    uint16_t sequence;
+    uint8_t sample_format;
+    uint8_t sensor_mask;
+    uint8_t sample_count;
+    uint8_t committed_sample_count;
+    uint8_t record_write_count;
+    uint8_t closed_record_buffer[LOG_RECORD_SIZE];
+    uint16_t closed_record_index;
+    uint16_t closed_record_length;
+    uint8_t closed_record_write_count;
+    DeltaStreamState delta_state;
+    LogVerifyPolicy verify_policy;
+    bool verify_pending;
+    uint16_t verify_record_index;
+    uint16_t verify_length;
+    uint16_t verify_crc;
+    uint16_t scrub_record_index;
+    LogHealthCounters health_counters;
+};
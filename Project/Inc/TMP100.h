@@ -9,6 +9,28 @@
 
 #include "stm32f4xx_hal.h"
 
+// Detection of completed one-shot conversions
+//   FixedDelay  The result is read once the conversion time of the current resolution has elapsed
+//   Adaptive    The OS/ALERT bit is polled at a fixed interval, starting shortly before the learned
+//               conversion time; the fixed conversion time remains the upper bound
+enum class TMP100WaitMode : uint8_t
+{
+	FixedDelay,
+	Adaptive
+};
+
+// Measured conversion latencies, from the start of a conversion to its detected completion
+struct TMP100ConversionStats
+{
+	uint32_t count;
+	uint32_t last_ms;
+	uint32_t min_ms;
+	uint32_t max_ms;
+	uint32_t total_ms;
+	uint32_t poll_count;
+	uint32_t timeout_count;
+};
+
 class TMP100
 {
 public:
@@ -16,21 +38,59 @@ public:
 	TMP100(I2C_HandleTypeDef *i2c_handle, uint8_t i2c_address);
 
 	// Public methods
+	uint8_t getI2CAddress();
 	HAL_StatusTypeDef writeConfigurationReg(uint8_t config_byte);
 	HAL_StatusTypeDef triggerOneShotTemperatureConversion();
+	HAL_StatusTypeDef startConversion();
+	bool isConversionDone();
+	uint32_t getConversionDeadline();
+	void setWaitMode(TMP100WaitMode mode, uint32_t poll_interval_ms);
+	TMP100WaitMode getWaitMode();
+	uint32_t getConversionEstimate();
+	const TMP100ConversionStats &getConversionStats();
+	uint32_t getTransactionCount();
 	HAL_StatusTypeDef readTemperatureReg(uint16_t *temperature);
 	float convertRawTemperatureDataToCelsius(uint16_t raw_temperature_data);
+	int16_t convertRawTemperatureDataToQ8_8(uint16_t raw_temperature_data);
+	int16_t convertRawTemperatureDataToCentiCelsius(uint16_t raw_temperature_data);
+	uint8_t getResolutionBits();
+	HAL_StatusTypeDef setResolutionBits(uint8_t resolution_bits);
+	HAL_StatusTypeDef setContinuousConversion(bool enabled);
+
+	// Static methods
+	static uint32_t getConversionTime(uint8_t resolution_bits);
 
 private:
 	// Private helper methods
 	void updateResolutionBits(uint8_t config_byte);
-	HAL_StatusTypeDef writePointerReg(uint8_t reg_address);
+	HAL_StatusTypeDef transmit(uint8_t *buffer, uint16_t length);
+	HAL_StatusTypeDef receive(uint8_t *buffer, uint16_t length);
+	HAL_StatusTypeDef readRegister(uint8_t reg_address, uint8_t *buffer, uint16_t length);
 	HAL_StatusTypeDef readConfigurationReg(uint8_t *config_byte);
+	HAL_StatusTypeDef writeLimitRegs(uint16_t limit);
+	HAL_StatusTypeDef armCompletionDetection();
+	bool pollCompletion(uint32_t elapsed_ms);
+	void recordConversionTime(uint32_t conversion_ms, bool timed_out);
 
 	// Data members
 	I2C_HandleTypeDef *i2c_handle;
 	uint8_t i2c_address;
 	uint8_t resolution_bits;
+	uint8_t config_shadow;
+	bool config_shadow_valid;
+	uint8_t pointer_reg;
+	uint32_t transaction_count;
+	bool conversion_pending;
+	uint32_t conversion_start_ms;
+	uint32_t conversion_time_ms;
+	TMP100WaitMode wait_mode;
+	uint32_t poll_interval_ms;
+	uint32_t next_poll_ms;
+	bool detection_armed;
+	bool alert_state_known;
+	uint8_t alert_state;
+	uint32_t conversion_estimate_ms[4];
+	TMP100ConversionStats conversion_stats;
 
 	// Static constant members
 	static const float resolution[4];
@@ -0,0 +1,41 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TMP100Array.h
+ * @brief Header file for the TMP100Array class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#include "TMP100.h"
+
+// Maximum number of TMP100 sensors on one bus (the ADD0 and ADD1 pins, each tied to GND or V+ or left
+// floating, select addresses 0x48 to 0x4F)
+constexpr uint8_t TMP100_ARRAY_MAX_SENSORS = 8;
+
+// Lowest TMP100 address, bit 0 of a sensor mask
+constexpr uint8_t TMP100_BASE_ADDRESS = 0x48;
+
+class TMP100Array
+{
+public:
+	// Constructor
+	TMP100Array(TMP100 *const *sensors, uint8_t sensor_count);
+
+	// Public methods
+	uint8_t getSensorCount();
+	uint8_t getSensorMask();
+	TMP100 *getSensor(uint8_t sensor_index);
+	HAL_StatusTypeDef setResolutionBits(uint8_t resolution_bits);
+	HAL_StatusTypeDef startConversions();
+	bool areConversionsDone();
+	HAL_StatusTypeDef readTemperatures(uint16_t *raw_temperatures, uint8_t *sensor_mask);
+
+private:
+	// Data members
+	TMP100 *sensors[TMP100_ARRAY_MAX_SENSORS];
+	uint8_t sensor_mask;
+	uint8_t pending_mask;
+};
@@ -0,0 +1,56 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TMP100Burst.h
+ * @brief Header file for the TMP100Burst class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#include "TMP100.h"
+
+// Maximum number of samples of a burst, held in RAM until they are streamed out (6 KiB with the
+// timestamps; about 41 s at 9-bit and 5.5 min at 12-bit resolution)
+constexpr uint16_t TMP100_BURST_MAX_SAMPLES = 1024;
+
+// Timing of the reads of a burst, measured with the cycle counter at the start of each read
+struct TMP100BurstStats
+{
+	uint32_t sample_count;
+	uint32_t period_us;
+	uint32_t duration_us;
+	uint32_t min_interval_us;
+	uint32_t max_interval_us;
+	uint32_t total_deviation_us;
+	uint32_t overrun_count;
+};
+
+class TMP100Burst
+{
+public:
+	// Constructor
+	TMP100Burst(TMP100 *temperature_sensor);
+
+	// Public methods
+	HAL_StatusTypeDef capture(uint8_t resolution_bits, uint32_t window_ms, uint32_t period_ms);
+	uint16_t getSampleCount();
+	uint16_t getSample(uint16_t sample_index);
+	uint32_t getTimestamp(uint16_t sample_index);
+	const TMP100BurstStats &getStats();
+	uint32_t getSampleRate();
+	uint32_t getMeanJitter();
+
+private:
+	// Private helper methods
+	HAL_StatusTypeDef readSamples(uint32_t window_ms, uint32_t period_ms);
+	void recordInterval(uint32_t interval_us);
+
+	// Data members
+	TMP100 *temperature_sensor;
+	uint16_t samples[TMP100_BURST_MAX_SAMPLES];
+	uint32_t timestamps_us[TMP100_BURST_MAX_SAMPLES];
+	uint16_t sample_count;
+	TMP100BurstStats stats;
+};
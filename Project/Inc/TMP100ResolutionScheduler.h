@@ -0,0 +1,67 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TMP100ResolutionScheduler.h
+ * @brief Header file for the TMP100ResolutionScheduler class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+// Policy of the resolution scheduler, with temperatures in Q8.8 format (1/256C per LSB). The
+// resolution is decided once per window of window_samples samples, so that log records, which hold
+// a single resolution, are not closed on every sample:
+//   Alarm       Within alarm_margin of alarm_low or alarm_high: maximum resolution, applied at once
+//               and held until a window passes without a sample near a threshold
+//   Fast        Smoothed change between two samples from fast_rate upwards: minimum resolution,
+//               the steps exceed the finer resolutions anyway
+//   Slow trend  Net change over the window from trend_change upwards: maximum resolution
+//   Flat        Otherwise: minimum resolution, a finer reading only adds noise
+// The maximum resolution is capped to the longest conversion that fits conversion_budget_ms.
+struct TMP100ResolutionPolicy
+{
+	uint8_t min_resolution_bits;
+	uint8_t max_resolution_bits;
+	int16_t alarm_low;
+	int16_t alarm_high;
+	int16_t alarm_margin;
+	int16_t trend_change;
+	int16_t fast_rate;
+	uint32_t conversion_budget_ms;
+	uint16_t window_samples;
+};
+
+// Maximum number of sensors whose readings drive the scheduler
+constexpr uint8_t TMP100_SCHEDULER_MAX_SENSORS = 8;
+
+class TMP100ResolutionScheduler
+{
+public:
+	// Constructor
+	TMP100ResolutionScheduler(const TMP100ResolutionPolicy &policy, uint8_t resolution_bits);
+
+	// Public methods
+	uint8_t update(const int16_t *temperatures, uint8_t sensor_count);
+	uint8_t getResolutionBits();
+	int16_t getChangeRate();
+	uint32_t getChangeCount();
+
+private:
+	// Private helper methods
+	uint8_t getMaxResolutionBits();
+	bool isNearAlarm(const int16_t *temperatures, uint8_t sensor_count);
+	void setResolutionBits(uint8_t resolution_bits);
+	void startWindow(const int16_t *temperatures, uint8_t sensor_count);
+
+	// Data members
+	TMP100ResolutionPolicy policy;
+	uint8_t resolution_bits;
+	uint8_t sensor_count;
+	int16_t previous_temperatures[TMP100_SCHEDULER_MAX_SENSORS];
+	int16_t window_temperatures[TMP100_SCHEDULER_MAX_SENSORS];
+	uint16_t window_sample_count;
+	bool window_near_alarm;
+	int32_t change_rate;
+	uint32_t change_count;
+};
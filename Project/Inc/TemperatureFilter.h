@@ -0,0 +1,59 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TemperatureFilter.h
+ * @brief Header file for the TemperatureFilter class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+// Streaming filters for temperatures in Q8.8 format (1/256C per LSB), in integer arithmetic only
+//   None           Passes the samples through
+//   MovingAverage  Mean of the last N samples (running sum), the noise drops by sqrt(N)
+//   Median         Median of the last N samples (sorted window), rejects spikes of up to (N - 1) / 2
+//                  samples without smearing them into the neighbouring samples
+//   EWMA           First-order IIR y += (x - y) / N with N a power of two, kept with 8 extra
+//                  fraction bits; responds to a step after about N samples
+enum class FilterType : uint8_t
+{
+    None,
+    MovingAverage,
+    Median,
+    EWMA
+};
+
+// Largest window of the moving average and median filters, and largest N of the EWMA filter
+constexpr uint8_t FILTER_MAX_LENGTH = 16;
+
+class TemperatureFilter
+{
+public:
+    // Constructor
+    TemperatureFilter(FilterType type = FilterType::None, uint8_t length = 1);
+
+    // Public methods
+    int16_t update(int16_t sample);
+    void reset();
+    bool isSettled();
+    FilterType getType();
+    uint8_t getLength();
+
+private:
+    // Private helper methods
+    int16_t updateMovingAverage(int16_t sample);
+    int16_t updateMedian(int16_t sample);
+    int16_t updateEWMA(int16_t sample);
+
+    // Data members
+    FilterType type;
+    uint8_t length;
+    uint8_t ewma_shift;
+    uint8_t sample_count;
+    uint8_t window_index;
+    int16_t window[FILTER_MAX_LENGTH];
+    int16_t sorted_window[FILTER_MAX_LENGTH];
+    int32_t window_sum;
+    int32_t ewma_state;
+};
@@ -0,0 +1,91 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file UARTLogger.h
+ * @brief Header file for the UARTLogger class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <stdarg.h>
+
+#include "stm32f4xx_hal.h"
+
+// Size of the transmit ring buffer (about 180 ms of output at 115200 baud)
+constexpr uint16_t UART_LOGGER_BUFFER_SIZE = 2048;
+
+// Largest message formatted into the ring buffer in one piece. A reservation that runs past the end
+// of the ring buffer continues into a tail of this size, which is moved to the start on commit, so
+// every reservation is contiguous
+constexpr uint16_t UART_LOGGER_MAX_MESSAGE_LENGTH = 256;
+
+// Handling of messages that do not fit into the free part of the ring buffer
+//   DropOldest  Discards the oldest bytes not yet handed to the DMA to make room
+//   DropNewest  Keeps the buffered bytes and discards the part of the message that does not fit
+//   Block       Waits for the DMA to free enough space (not from interrupt handlers)
+enum class UARTOverflowPolicy : uint8_t
+{
+    DropOldest,
+    DropNewest,
+    Block
+};
+
+// Formats a message into the buffer like snprintf: writes at most buffer_size - 1 characters and
+// a terminating null character, and returns the length of the complete message or a negative value
+// on error. Called up to twice per message by UARTLogger::writeFormatted
+typedef int (*UARTMessageFormatter)(char *buffer, size_t buffer_size, void *context);
+
+class UARTLogger
+{
+public:
+    // Constructor
+    UARTLogger(UART_HandleTypeDef *uart_handle, UARTOverflowPolicy overflow_policy);
+
+    // Public methods
+    void setOverflowPolicy(UARTOverflowPolicy overflow_policy);
+    HAL_StatusTypeDef write(const uint8_t *data, uint16_t length);
+    HAL_StatusTypeDef writeFrame(const uint8_t *data, uint16_t length);
+    HAL_StatusTypeDef writeFormatted(const char *format, va_list arguments);
+    HAL_StatusTypeDef writeFormatted(UARTMessageFormatter formatter, void *context);
+    char *reserve(uint16_t length, uint16_t *reserved_length);
+    void commit(uint16_t length);
+    HAL_StatusTypeDef flush(uint32_t timeout_ms);
+    uint16_t getBufferedByteCount();
+    uint16_t getPeakBufferedByteCount();
+    uint32_t getDroppedByteCount();
+
+    // Interrupt handlers (called from the HAL UART callbacks)
+    void handleTransferComplete();
+    void handleTransferError();
+
+    // Static methods
+    static UARTLogger *getInstance(UART_HandleTypeDef *uart_handle);
+
+private:
+    // Format string and arguments of the printf-style writeFormatted
+    struct PrintfContext
+    {
+        const char *format;
+        va_list arguments;
+    };
+
+    // Private helper methods
+    void dropOldestBytes(uint16_t length);
+    void startTransfer();
+    void releaseTransfer();
+    static int formatPrintfMessage(char *buffer, size_t buffer_size, void *context);
+
+    // Data members
+    UART_HandleTypeDef *uart_handle;
+    UARTOverflowPolicy overflow_policy;
+    uint8_t buffer[UART_LOGGER_BUFFER_SIZE + UART_LOGGER_MAX_MESSAGE_LENGTH];
+    volatile uint16_t used_count;
+    volatile uint16_t pending_index;
+    volatile uint16_t pending_count;
+    volatile uint16_t transfer_length;
+    uint16_t peak_used_count;
+    volatile uint32_t dropped_byte_count;
+
+    // Static members
+    static UARTLogger *instances[6];
+};
@@ -0,0 +1,35 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_benchmark.h
+ * @brief Header file to define on-target benchmark routines.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#include "EEPROM.h"
+#include "EEPROMLog.h"
+#include "TMP100.h"
+#include "TemperatureFilter.h"
+
+namespace benchmark
+{
+    void runI2CReadBenchmark(I2C_HandleTypeDef *i2c_handle, uint8_t tmp100_i2c_address, uint8_t eeprom_i2c_address,
+                             UART_HandleTypeDef *uart_handle);
+
+    void runEEPROMReadBenchmark(EEPROM *eeprom, UART_HandleTypeDef *uart_handle);
+
+    void runLogDecodeBenchmark(EEPROMLog *eeprom_log, UART_HandleTypeDef *uart_handle);
+
+    void runDeltaCodecBenchmark(EEPROMLog *eeprom_log, UART_HandleTypeDef *uart_handle);
+
+    void runTemperatureFormatBenchmark(TMP100 *temperature_sensor, UART_HandleTypeDef *uart_handle);
+
+    void runFilterBenchmark(UART_HandleTypeDef *uart_handle);
+
+    void runUARTLogBenchmark(UART_HandleTypeDef *uart_handle);
+
+    void runTokenLogBenchmark(UART_HandleTypeDef *uart_handle);
+}
@@ -0,0 +1,57 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_codec.h
+ * @brief Header file to define the sample storage codecs.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Delta stream layout: a keyframe holding the first value at full width, followed by one code per
+// sample, most significant bit first
+//   0x0-0xD   Zigzag-coded delta from the previous value of the channel (-7 to +6)
+//   0xE n     Run of n + 3 values unchanged from the previous value of their channel (3 to 18)
+//   0xF v     Escape: the value v at full width
+// A stream may interleave the values of several channels (e.g. one per sensor) in a fixed order;
+// each value is then predicted from the previous value of its own channel, and the keyframe is the
+// initial prediction for all channels.
+constexpr uint8_t DELTA_MAX_ZIGZAG_CODE = 0xD;
+constexpr uint8_t DELTA_RUN_CODE = 0xE;
+constexpr uint8_t DELTA_ESCAPE_CODE = 0xF;
+constexpr uint8_t DELTA_MIN_RUN_LENGTH = 3;
+constexpr uint8_t DELTA_MAX_RUN_LENGTH = DELTA_MIN_RUN_LENGTH + 0xF;
+constexpr uint8_t DELTA_MAX_CHANNELS = 8;
+
+// Encoder position in a delta stream, also restored by the decoder to resume a stream
+struct DeltaStreamState
+{
+    uint16_t bit_offset;
+    uint16_t previous_value;
+    uint16_t run_offset;
+    uint8_t run_length;
+    uint8_t zero_count;
+    uint8_t channel_count;
+    uint8_t channel_index;
+    uint16_t channel_values[DELTA_MAX_CHANNELS];
+};
+
+namespace codec
+{
+    void packBits(uint8_t *buffer, uint32_t bit_offset, uint16_t value, uint8_t bit_width);
+
+    uint16_t unpackBits(const uint8_t *buffer, uint32_t bit_offset, uint8_t bit_width);
+
+    void unpackSamples(const uint8_t *buffer, uint16_t sample_count, uint8_t bit_width, uint16_t *samples);
+
+    void startDeltaStream(uint8_t *buffer, uint16_t value, uint8_t bit_width, uint8_t channel_count, DeltaStreamState *state);
+
+    bool appendDeltaSample(uint8_t *buffer, uint16_t capacity_bits, uint16_t value, uint8_t bit_width, DeltaStreamState *state);
+
+    uint16_t decodeDeltaStream(const uint8_t *buffer, uint16_t capacity_bits, uint16_t sample_count, uint8_t bit_width,
+                               uint8_t channel_count, uint16_t *samples, DeltaStreamState *state);
+
+    uint16_t calculateCRC16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF);
+}
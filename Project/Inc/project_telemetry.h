@@ -0,0 +1,63 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_telemetry.h
+ * @brief Header file to define the binary telemetry packets, shared with the host-side parser.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Telemetry packet layout before framing (multi-byte fields big-endian):
+//   Byte 0      Packet type (TELEMETRY_PACKET_TYPE_SAMPLE)
+//   Bytes 1-2   Sequence number, incremented per packet, so that the host can count lost packets
+//   Bytes 3-6   Timestamp in milliseconds since start-up
+//   Byte 7      Sensor id (7-bit I2C address of the TMP100)
+//   Bytes 8-9   Raw sample (left-justified Temperature Register value, Q8.8 degrees Celsius)
+//   Byte 10     Status flags (see below)
+//   Bytes 11-12 CRC-16/CCITT-FALSE over bytes 0-10
+// Each packet is COBS-encoded (Consistent Overhead Byte Stuffing), which removes all zero bytes at
+// a cost of one byte, and sent between two 0x00 delimiters. A receiver resynchronizes at the next
+// delimiter after lost bytes, and text messages sent between packets (e.g. errors and statistics)
+// end up between two delimiters of their own, where they fail the length and CRC checks. This only
+// holds for the text log encoding: log frames of the tokenized encoding contain zero bytes, so the
+// firmware does not combine them with telemetry
+constexpr uint8_t TELEMETRY_PACKET_TYPE_SAMPLE = 0x01;
+constexpr uint8_t TELEMETRY_PACKET_SIZE = 13;
+constexpr uint8_t TELEMETRY_ENCODED_PACKET_SIZE = TELEMETRY_PACKET_SIZE + 1;
+constexpr uint8_t TELEMETRY_FRAME_SIZE = TELEMETRY_ENCODED_PACKET_SIZE + 2;
+constexpr uint8_t TELEMETRY_FRAME_DELIMITER = 0x00;
+
+// Status flags of a sample
+//   RESOLUTION_MASK  Resolution of the sample (R1R0: 0 = 9 bits ... 3 = 12 bits)
+//   FILTERED         The sample is the output of the temperature filter, not a single conversion
+//   EVENT            The scan is stored in the EEPROM log as read, not as a repeat of the last logged scan (always
+//                    set without event logging)
+//   LOG_ERROR        An EEPROM log operation (sensor mask, append, flush, or format change) failed since the previous scan
+constexpr uint8_t TELEMETRY_FLAG_RESOLUTION_MASK = 0x03;
+constexpr uint8_t TELEMETRY_FLAG_FILTERED = 0x04;
+constexpr uint8_t TELEMETRY_FLAG_EVENT = 0x08;
+constexpr uint8_t TELEMETRY_FLAG_LOG_ERROR = 0x10;
+
+// Contents of a telemetry packet
+struct TelemetrySample
+{
+    uint16_t sequence;
+    uint32_t timestamp_ms;
+    uint8_t sensor_id;
+    uint16_t raw_sample;
+    uint8_t status_flags;
+};
+
+namespace telemetry
+{
+    size_t encodeCOBS(const uint8_t *data, size_t length, uint8_t *encoded);
+
+    size_t decodeCOBS(const uint8_t *encoded, size_t length, uint8_t *data);
+
+    size_t encodeFrame(const TelemetrySample &sample, uint8_t *frame);
+
+    bool decodePacket(const uint8_t *encoded, size_t length, TelemetrySample *sample);
+}
@@ -0,0 +1,199 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_tokenlog.h
+ * @brief Header file to define the tokenized log messages, shared with the host-side decoder.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Log frame layout: instead of the formatted text, the tokenized log mode sends
+//   Byte 0      Frame start (0x1E, never part of a text message, so frames and text can be mixed)
+//   Byte 1      Token, the index of the format string in LOG_TOKEN_TABLE
+//   Bytes 2-    One zigzag-coded LEB128 varint per argument (1 to 5 bytes, 7 bits per byte, least
+//               significant group first), as many as the format string has conversions
+// Format strings are expanded by tokenlog::expandMessage on the device in the text mode and in the
+// host-side decoder (Tools/log_decoder.cpp), not by printf. All arguments are 32-bit integers:
+//   %d %u %x %X   Signed, unsigned, and hexadecimal integer, with an optional 0 flag and width
+//   %.Nf          Fixed-point integer with N decimal places (value / 10^N), e.g. %.2f for centi-Celsius
+//   %%            Percent sign
+constexpr uint8_t LOG_FRAME_START = 0x1E;
+constexpr uint8_t LOG_MAX_ARGUMENTS = 12;
+constexpr uint8_t LOG_MAX_FRAME_SIZE = 2 + 5 * LOG_MAX_ARGUMENTS;
+
+// Severity of a log message, from the most to the least important; bit n of a level mask stands for level n
+//   Error    Failed operations; the sample or the program is lost
+//   Warning  Degraded operation that the program works around
+//   Info     Start-up messages and the periodic statistics
+//   Debug    Per-sample output ("Current Temperature", "Wrote ... samples")
+enum class LogLevel : uint8_t
+{
+    Error,
+    Warning,
+    Info,
+    Debug
+};
+
+// Subsystem a log message belongs to; bit n of a category mask stands for category n
+enum class LogCategory : uint8_t
+{
+    Sensor,
+    EEPROM,
+    I2C,
+    System
+};
+
+constexpr uint8_t LOG_LEVEL_MASK_ALL = 0b1111;
+constexpr uint8_t LOG_CATEGORY_MASK_ALL = 0b1111;
+
+// Compile-time log filter: messages above LOG_COMPILE_LEVEL or outside LOG_COMPILE_CATEGORY_MASK compile
+// to nothing, and their format strings are left out of flash. Set here rather than in project_main.cpp,
+// as the host-side decoder is built from the same table (and sends no filtered message anyway)
+constexpr LogLevel LOG_COMPILE_LEVEL = LogLevel::Debug;
+constexpr uint8_t LOG_COMPILE_CATEGORY_MASK = LOG_CATEGORY_MASK_ALL;
+
+// Token table: X(name, level, category, format) per message. New messages are appended, so that the
+// tokens of a decoder built from an older table stay valid; the table hash sent at start-up detects a
+// mismatch
+#define LOG_TOKEN_TABLE(X)                                                                                            \
+    X(TableHash, Info, System, "Log token table 0x%08X.\r\n")                                                         \
+    X(WriteCycleStats, Info, EEPROM, "Write cycle: n=%u min=%u avg=%u max=%u us.\r\n")                                \
+    X(WriteCycleHistogram, Info, EEPROM, "Write cycle %%: %u %u %u %u %u %u %u %u %u %u %u\r\n")                      \
+    X(TransactionStats, Info, I2C, "TMP100 0x%02X: %u I2C transactions in %u samples.\r\n")                           \
+    X(ConversionStats, Info, Sensor, "Conversion: min=%u avg=%u max=%u ms polls=%u to=%u.\r\n")                       \
+    X(LogHealth, Info, EEPROM, "Log health: ok=%u bad=%u rd_err=%u scrubs=%u wr_err=%u.\r\n")                         \
+    X(UARTLogStats, Info, System, "UART log: peak %u of %u bytes, %u dropped.\r\n")                                   \
+    X(EEPROMWriteFailed, Error, EEPROM, "Error: Failed to write EEPROM 0x%02X at address 0x%04X!\r\n")                \
+    X(I2CBusTimeout, Error, I2C, "Error: Timed out waiting for the I2C bus!\r\n")                                     \
+    X(ConversionTriggerFailed, Error, Sensor, "Error: Failed to trigger One-Shot temperature conversion!\r\n")        \
+    X(TemperatureReadFailed, Error, Sensor, "Error: Failed to read temperature data from TMP100!\r\n")                \
+    X(BurstCaptureFailed, Error, Sensor, "Error: Failed to capture %u-bit burst!\r\n")                                \
+    X(BurstSample, Info, Sensor, "%u,%.4f\r\n")                                                                       \
+    X(BurstStats, Info, Sensor, "Burst %u-bit: n=%u rate=%.3f Hz overruns=%u.\r\n")                                   \
+    X(BurstJitter, Info, Sensor, "Burst jitter: min=%d max=%d mean=%u us.\r\n")                                       \
+    X(SensorConfigurationFailed, Error, Sensor, "Error: Failed to configure TMP100 0x%02X! Terminating program.\r\n") \
+    X(LogRecoveryFailed, Error, EEPROM, "Error: Failed to recover EEPROM log! Terminating program.\r\n")              \
+    X(LogFormatFailed, Error, EEPROM, "Error: Failed to set EEPROM log sample format!\r\n")                           \
+    X(LogResumed, Info, EEPROM, "Resumed EEPROM log at address 0x%05X in %u us.\r\n")                                 \
+    X(CurrentTemperature, Debug, Sensor, "Current Temperature 0x%02X: %.2f°C.\r\n")                                   \
+    X(LogSensorMaskFailed, Error, EEPROM, "Error: Failed to set EEPROM log sensors!\r\n")                             \
+    X(LogWriteFailed, Error, EEPROM, "Error: Failed to write temperature data to EEPROM!\r\n")                        \
+    X(SamplesWritten, Debug, EEPROM, "Wrote %u samples to EEPROM at address 0x%05X.\r\n")                             \
+    X(LogFlushFailed, Error, EEPROM, "Error: Failed to flush EEPROM log!\r\n")                                        \
+    X(ResolutionChangeFailed, Error, Sensor, "Error: Failed to set TMP100 resolution!\r\n")                           \
+    X(ResolutionStats, Info, Sensor, "Resolution: %u bits, %u changes, rate=%d/256C.\r\n")                            \
+    X(EventStats, Info, EEPROM, "Events: %u in %u samples.\r\n")                                                      \
+    X(OutputModeText, Info, System, "Output: text.\r\n")                                                              \
+    X(OutputModeTelemetry, Info, System, "Output: binary telemetry.\r\n")                                             \
+    X(LogLevelMask, Info, System, "Log level mask: 0x%X.\r\n")
+
+// Log message tokens
+enum class LogToken : uint8_t
+{
+#define LOG_TOKEN_NAME(name, level, category, format) name,
+    LOG_TOKEN_TABLE(LOG_TOKEN_NAME)
+#undef LOG_TOKEN_NAME
+    Count
+};
+
+// Levels and categories, indexed by token
+constexpr LogLevel LOG_TOKEN_LEVELS[] = {
+#define LOG_TOKEN_LEVEL(name, level, category, format) LogLevel::level,
+    LOG_TOKEN_TABLE(LOG_TOKEN_LEVEL)
+#undef LOG_TOKEN_LEVEL
+};
+
+constexpr LogCategory LOG_TOKEN_CATEGORIES[] = {
+#define LOG_TOKEN_CATEGORY(name, level, category, format) LogCategory::category,
+    LOG_TOKEN_TABLE(LOG_TOKEN_CATEGORY)
+#undef LOG_TOKEN_CATEGORY
+};
+
+// Encoding of the log messages on the UART
+//   Text       Messages are expanded on the device and sent as text
+//   Tokenized  Messages are sent as log frames and expanded by the host-side decoder
+enum class LogEncoding : uint8_t
+{
+    Text,
+    Tokenized
+};
+
+namespace tokenlog
+{
+    /**
+     * @brief Counts the conversions of a format string, i.e. the number of arguments it expects.
+     * Evaluated at compile time to check the arguments of each logged message.
+     * @param format The null-terminated format string.
+     * @return The number of conversions, not counting %%.
+     */
+    constexpr uint8_t countArguments(const char *format)
+    {
+        uint8_t argument_count = 0;
+
+        for (size_t i = 0; format[i] != '\0'; i++)
+        {
+            if (format[i] != '%')
+            {
+                continue;
+            }
+
+            if (format[i + 1] == '%')
+            {
+                i++;
+                continue;
+            }
+
+            argument_count++;
+        }
+
+        return argument_count;
+    }
+
+    /**
+     * @brief Builds the level mask of all levels up to the specified one.
+     * @param max_level The least important level to include.
+     * @return The level mask.
+     */
+    constexpr uint8_t getLevelMask(LogLevel max_level)
+    {
+        return (2 << static_cast<uint8_t>(max_level)) - 1;
+    }
+
+    /**
+     * @brief Checks whether a message passes the compile-time log filter.
+     * @param token The token of the message.
+     * @return True if the message is compiled in, false if it compiles to nothing.
+     */
+    constexpr bool isTokenCompiled(LogToken token)
+    {
+        uint8_t index = static_cast<uint8_t>(token);
+
+        return LOG_TOKEN_LEVELS[index] <= LOG_COMPILE_LEVEL &&
+               (LOG_COMPILE_CATEGORY_MASK & (1 << static_cast<uint8_t>(LOG_TOKEN_CATEGORIES[index])));
+    }
+
+    uint32_t calculateTableHash();
+
+    size_t expandMessage(char *buffer, size_t buffer_size, const char *format, const int32_t *arguments, uint8_t argument_count);
+
+    size_t encodeFrame(uint8_t *buffer, LogToken token, const int32_t *arguments, uint8_t argument_count);
+
+    size_t decodeFrame(const uint8_t *frame, size_t length, LogToken *token, int32_t *arguments, uint8_t *argument_count);
+}
+
+// Format strings, indexed by token; empty for the messages removed by the compile-time log filter
+constexpr const char *LOG_TOKEN_FORMATS[] = {
+#define LOG_TOKEN_FORMAT(name, level, category, format) tokenlog::isTokenCompiled(LogToken::name) ? format : "",
+    LOG_TOKEN_TABLE(LOG_TOKEN_FORMAT)
+#undef LOG_TOKEN_FORMAT
+};
+
+// Number of arguments of each message, counted from the complete format strings
+constexpr uint8_t LOG_TOKEN_ARGUMENT_COUNTS[] = {
+#define LOG_TOKEN_ARGUMENT_COUNT(name, level, category, format) tokenlog::countArguments(format),
+    LOG_TOKEN_TABLE(LOG_TOKEN_ARGUMENT_COUNT)
+#undef LOG_TOKEN_ARGUMENT_COUNT
+};
@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+#include "project_telemetry.h"
+#include "project_tokenlog.h"
+
 namespace utility
 {
     uint8_t getI2CReadAddress(uint8_t i2c_address);
@@ -19,5 +23,54 @@ namespace utility
 
     void logStatusMessage(UART_HandleTypeDef *uart_handle, char *status_message);
 
+    void logFormattedMessage(UART_HandleTypeDef *uart_handle, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    void setLogEncoding(LogEncoding log_encoding);
+
+    void setLogLevelMask(uint8_t level_mask);
+
+    uint8_t getLogLevelMask();
+
+    void setLogCategoryMask(uint8_t category_mask);
+
+    bool isLogEnabled(LogToken token);
+
+    void logTokenMessage(UART_HandleTypeDef *uart_handle, LogToken token, const int32_t *arguments, uint8_t argument_count);
+
+    /**
+     * @brief Logs a message of the token table via UART, as text or as a log frame depending on the
+     * log encoding. The number of arguments is checked against the format string at compile time.
+     * Messages removed by the compile-time log filter compile to nothing; messages disabled by the
+     * runtime masks return before they are formatted.
+     * @tparam token The token of the message.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     * @param arguments The arguments of the format string, converted to 32-bit integers.
+     */
+    template <LogToken token, typename... Arguments>
+    void logToken([[maybe_unused]] UART_HandleTypeDef *uart_handle, [[maybe_unused]] Arguments... arguments)
+    {
+        static_assert(LOG_TOKEN_ARGUMENT_COUNTS[static_cast<uint8_t>(token)] == sizeof...(Arguments),
+                      "Argument count does not match the format string of the token");
+
+        if constexpr (tokenlog::isTokenCompiled(token))
+        {
+            // The leading element keeps the array non-empty for messages without arguments
+            const int32_t values[] = {0, static_cast<int32_t>(arguments)...};
+            logTokenMessage(uart_handle, token, &values[1], sizeof...(Arguments));
+        }
+    }
+
+    void logTelemetrySample(UART_HandleTypeDef *uart_handle, const TelemetrySample &sample);
+
     void scanI2CAddresses(I2C_HandleTypeDef *i2c_handle, UART_HandleTypeDef *uart_handle);
+
+    void enableCycleCounter();
+
+    uint32_t getCycleCount();
+
+    uint32_t convertCyclesToMicroseconds(uint32_t cycles);
+
+    int16_t convertQ8_8ToCentiCelsius(int16_t q8_8_temperature);
+
+    size_t formatFixedPoint(char *buffer, size_t buffer_size, int32_t value, uint8_t decimal_places);
 }
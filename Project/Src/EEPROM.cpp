@@ -5,17 +5,20 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+#include <string.h>
+
 #include "eeprom.h"
 #include "project_utility.h"
 
-// EEPROM address range
-constexpr uint16_t EEPROM_MIN_ADDRESS = 0x0000;
-constexpr uint16_t EEPROM_MAX_ADDRESS = 0x7FFF;
+// EEPROM timing (the 24FC256 write cycle takes at most 5 ms)
+constexpr uint32_t EEPROM_WRITE_CYCLE_TIMEOUT_MS = 10;
+constexpr uint32_t EEPROM_ACK_POLL_TIMEOUT_MS = 2;
 
-// EEPROM timing
-constexpr uint32_t EEPROM_WRITE_CYCLE_DELAY_MS = 5;
+// Maximum number of bytes received per I2C transaction during a sequential read
+constexpr uint16_t EEPROM_READ_CHUNK_SIZE = 256;
 
 using utility::getI2CReadAddress, utility::getI2CWriteAddress;
+using utility::getCycleCount, utility::convertCyclesToMicroseconds;
 
 /**
  * ------------------------------------------------------------------------------------------------
@@ -31,6 +34,19 @@ using utility::getI2CReadAddress, utility::getI2CWriteAddress;
 EEPROM::EEPROM(I2C_HandleTypeDef *i2c_handle, uint8_t i2c_address) : i2c_handle(i2c_handle), i2c_address(i2c_address)
 {
     this->current_write_address = EEPROM_MIN_ADDRESS;
+    this->write_in_progress = false;
+    this->write_cycle_start_cycles = 0;
+    this->write_cycle_stats = {};
+    this->write_cycle_stats.min_us = UINT32_MAX;
+}
+
+/**
+ * @brief Retrieves the I2C address of the EEPROM.
+ * @return The 7-bit I2C address of the EEPROM device.
+ */
+uint8_t EEPROM::getI2CAddress()
+{
+    return this->i2c_address;
 }
 
 /**
@@ -68,15 +84,25 @@ void EEPROM::buildAddressBuffer(uint8_t *address_buffer, uint16_t memory_address
 }
 
 /**
- * @brief Writes two bytes of data to the EEPROM at the current write address.
+ * @brief Writes two bytes of data to the EEPROM at the current write address. The call returns as
+ * soon as the data is sent; the internal write cycle is completed by ACK polling before the next
+ * bus operation on the EEPROM.
  * @param data The 16-bit data value to be written to the EEPROM.
- * @return The HAL status of the I2C transmission.
+ * @return The HAL status of the I2C transmission. Returns HAL_TIMEOUT if the previous write cycle
+ * did not complete in time.
  */
 HAL_StatusTypeDef EEPROM::writeTwoBytes(uint16_t data)
 {
     HAL_StatusTypeDef status;
     uint8_t buffer[4];
 
+    status = this->waitForWriteComplete(EEPROM_WRITE_CYCLE_TIMEOUT_MS);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
     buildWriteBuffer(buffer, data);
 
     status = HAL_I2C_Master_Transmit(
@@ -91,19 +117,20 @@ HAL_StatusTypeDef EEPROM::writeTwoBytes(uint16_t data)
         return status;
     }
 
+    this->startWriteCycle();
+
     this->current_write_address += 2;
     if (this->current_write_address > EEPROM_MAX_ADDRESS)
     {
         this->current_write_address = EEPROM_MIN_ADDRESS;
     }
 
-    HAL_Delay(EEPROM_WRITE_CYCLE_DELAY_MS);
-
     return HAL_OK;
 }
 
 /**
- * @brief Reads two bytes of data from the specified EEPROM memory address.
+ * @brief Reads two bytes of data from the specified EEPROM memory address in a single random read
+ * (address write and data read joined by a repeated START).
  * @param memory_address The 16-bit valid memory address (0x0000 to 0x7FFF) to read from.
  * @param data Pointer to a 16-bit variable where the read data will be stored.
  * @return The HAL status of the I2C transmission.
@@ -121,16 +148,23 @@ HAL_StatusTypeDef EEPROM::readTwoBytes(uint16_t memory_address, uint16_t *data)
     }
 
     HAL_StatusTypeDef status;
-    uint8_t address_buffer[2];
     uint8_t buffer[2] = {0};
 
-    buildAddressBuffer(address_buffer, memory_address);
+    status = this->waitForWriteComplete(EEPROM_WRITE_CYCLE_TIMEOUT_MS);
 
-    status = HAL_I2C_Master_Transmit(
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    // Address write and data read in one transfer, joined by a repeated START
+    status = HAL_I2C_Mem_Read(
         this->i2c_handle,
         getI2CWriteAddress(this->i2c_address),
-        address_buffer,
-        sizeof(address_buffer),
+        memory_address,
+        I2C_MEMADD_SIZE_16BIT,
+        buffer,
+        sizeof(buffer),
         HAL_MAX_DELAY);
 
     if (status != HAL_OK)
@@ -138,11 +172,55 @@ HAL_StatusTypeDef EEPROM::readTwoBytes(uint16_t memory_address, uint16_t *data)
         return status;
     }
 
-    status = HAL_I2C_Master_Receive(
+    *data = (buffer[0] << 8) | buffer[1];
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Writes up to one page of data to the EEPROM in a single write cycle.
+ * @param memory_address The 16-bit valid memory address (0x0000 to 0x7FFF) of the first byte to write.
+ * @param data Pointer to the data to be written to the EEPROM.
+ * @param length The number of bytes to write (1 to EEPROM_PAGE_SIZE).
+ * @return The HAL status of the I2C transmission. Returns HAL_ERROR if the write would cross a page
+ * boundary, since the 24FC256 would wrap around to the start of the page and overwrite existing data.
+ * Like writeTwoBytes, the call does not wait for the internal write cycle.
+ */
+HAL_StatusTypeDef EEPROM::writePage(uint16_t memory_address, const uint8_t *data, uint16_t length)
+{
+    if (memory_address < EEPROM_MIN_ADDRESS || memory_address > EEPROM_MAX_ADDRESS)
+    {
+        return HAL_ERROR;
+    }
+
+    if (data == nullptr || length == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    if ((memory_address % EEPROM_PAGE_SIZE) + length > EEPROM_PAGE_SIZE)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status;
+    uint8_t buffer[2 + EEPROM_PAGE_SIZE];
+
+    status = this->waitForWriteComplete(EEPROM_WRITE_CYCLE_TIMEOUT_MS);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    buildAddressBuffer(buffer, memory_address);
+    memcpy(&buffer[2], data, length);
+
+    status = HAL_I2C_Master_Transmit(
         this->i2c_handle,
-        getI2CReadAddress(this->i2c_address),
+        getI2CWriteAddress(this->i2c_address),
         buffer,
-        sizeof(buffer),
+        2 + length,
         HAL_MAX_DELAY);
 
     if (status != HAL_OK)
@@ -150,7 +228,223 @@ HAL_StatusTypeDef EEPROM::readTwoBytes(uint16_t memory_address, uint16_t *data)
         return status;
     }
 
-    *data = (buffer[0] << 8) | buffer[1];
+    this->startWriteCycle();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reads a range of bytes from the EEPROM using the 24FC256 sequential read mode, sending the
+ * memory address once and then receiving the data in chunks. Ranges that run past 0x7FFF wrap
+ * around to 0x0000.
+ * @param start_address The 16-bit valid memory address (0x0000 to 0x7FFF) of the first byte to read.
+ * @param buffer Pointer to a buffer where the read data will be stored.
+ * @param length The number of bytes to read (at most the EEPROM capacity).
+ * @return The HAL status of the I2C operations.
+ */
+HAL_StatusTypeDef EEPROM::readRange(uint16_t start_address, uint8_t *buffer, uint16_t length)
+{
+    if (start_address < EEPROM_MIN_ADDRESS || start_address > EEPROM_MAX_ADDRESS)
+    {
+        return HAL_ERROR;
+    }
+
+    if (buffer == nullptr || length > EEPROM_SIZE)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status;
+    uint32_t bytes_to_end = EEPROM_MAX_ADDRESS - start_address + 1;
+
+    if (length <= bytes_to_end)
+    {
+        return this->readSequential(start_address, buffer, length);
+    }
+
+    status = this->readSequential(start_address, buffer, bytes_to_end);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    return this->readSequential(EEPROM_MIN_ADDRESS, &buffer[bytes_to_end], length - bytes_to_end);
+}
+
+/**
+ * @brief Checks without blocking whether the internal write cycle of the last write has completed.
+ * The 24FC256 does not acknowledge its device address while the write cycle is in progress, so a
+ * single address probe (ACK polling) tells whether the next bus operation can start.
+ * @return True if no write cycle is in progress, false otherwise.
+ */
+bool EEPROM::isWriteComplete()
+{
+    if (!this->write_in_progress)
+    {
+        return true;
+    }
+
+    HAL_StatusTypeDef status = HAL_I2C_IsDeviceReady(
+        this->i2c_handle,
+        getI2CWriteAddress(this->i2c_address),
+        1,
+        EEPROM_ACK_POLL_TIMEOUT_MS);
+
+    if (status != HAL_OK)
+    {
+        return false;
+    }
+
+    this->write_in_progress = false;
+    this->recordWriteCycleTime(convertCyclesToMicroseconds(getCycleCount() - this->write_cycle_start_cycles));
+
+    return true;
+}
+
+/**
+ * @brief Blocks until the internal write cycle of the last write has completed, using ACK polling.
+ * @param timeout_ms The maximum time to wait in milliseconds.
+ * @return HAL_OK once the EEPROM acknowledges its address, or HAL_TIMEOUT if it does not within
+ * the timeout. The timed-out write cycle is not recorded in the write cycle statistics.
+ */
+HAL_StatusTypeDef EEPROM::waitForWriteComplete(uint32_t timeout_ms)
+{
+    uint32_t start_ms = HAL_GetTick();
+
+    while (!this->isWriteComplete())
+    {
+        if (HAL_GetTick() - start_ms > timeout_ms)
+        {
+            // Give up on this write cycle so the next operation reports the real bus error
+            this->write_in_progress = false;
+            return HAL_TIMEOUT;
+        }
+    }
 
     return HAL_OK;
 }
+
+/**
+ * @brief Retrieves the write cycle times measured by ACK polling since construction.
+ * @return Reference to the write cycle statistics.
+ */
+const EEPROMWriteCycleStats &EEPROM::getWriteCycleStats()
+{
+    return this->write_cycle_stats;
+}
+
+/**
+ * @brief Marks the start of an internal write cycle after a write has been sent, so that the next
+ * operation waits for it by ACK polling. Also used by writes sent outside this class (e.g. via DMA).
+ */
+void EEPROM::startWriteCycle()
+{
+    this->write_in_progress = true;
+    this->write_cycle_start_cycles = getCycleCount();
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Reads a contiguous range of bytes that does not wrap around the end of the EEPROM. The
+ * address is sent once, joined to the first chunk by a repeated START; each following chunk is a
+ * current address read that continues from where the internal address counter of the 24FC256 stopped.
+ * @param start_address The 16-bit valid memory address of the first byte to read.
+ * @param buffer Pointer to a buffer where the read data will be stored.
+ * @param length The number of bytes to read.
+ * @return The HAL status of the I2C operations.
+ */
+HAL_StatusTypeDef EEPROM::readSequential(uint16_t start_address, uint8_t *buffer, uint16_t length)
+{
+    if (length == 0)
+    {
+        return HAL_OK;
+    }
+
+    HAL_StatusTypeDef status;
+
+    status = this->waitForWriteComplete(EEPROM_WRITE_CYCLE_TIMEOUT_MS);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    uint16_t offset = 0;
+
+    while (offset < length)
+    {
+        uint16_t chunk_length = length - offset;
+
+        if (chunk_length > EEPROM_READ_CHUNK_SIZE)
+        {
+            chunk_length = EEPROM_READ_CHUNK_SIZE;
+        }
+
+        if (offset == 0)
+        {
+            // The first chunk carries the address write, joined to the read by a repeated START
+            status = HAL_I2C_Mem_Read(
+                this->i2c_handle,
+                getI2CWriteAddress(this->i2c_address),
+                start_address,
+                I2C_MEMADD_SIZE_16BIT,
+                buffer,
+                chunk_length,
+                HAL_MAX_DELAY);
+        }
+        else
+        {
+            // Later chunks continue from the internal address counter of the 24FC256
+            status = HAL_I2C_Master_Receive(
+                this->i2c_handle,
+                getI2CReadAddress(this->i2c_address),
+                &buffer[offset],
+                chunk_length,
+                HAL_MAX_DELAY);
+        }
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        offset += chunk_length;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Adds a measured write cycle time to the write cycle statistics.
+ * @param write_cycle_us The measured write cycle time in microseconds.
+ */
+void EEPROM::recordWriteCycleTime(uint32_t write_cycle_us)
+{
+    EEPROMWriteCycleStats &stats = this->write_cycle_stats;
+    size_t bin = write_cycle_us / EEPROM_WRITE_CYCLE_HISTOGRAM_BIN_US;
+
+    if (bin >= EEPROM_WRITE_CYCLE_HISTOGRAM_BINS)
+    {
+        bin = EEPROM_WRITE_CYCLE_HISTOGRAM_BINS - 1;
+    }
+
+    stats.count++;
+    stats.total_us += write_cycle_us;
+    stats.histogram[bin]++;
+
+    if (write_cycle_us < stats.min_us)
+    {
+        stats.min_us = write_cycle_us;
+    }
+
+    if (write_cycle_us > stats.max_us)
+    {
+        stats.max_us = write_cycle_us;
+    }
+}
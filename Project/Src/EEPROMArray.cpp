@@ -0,0 +1,144 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file EEPROMArray.cpp
+ * @brief Implementation file for the EEPROMArray class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "EEPROMArray.h"
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs an EEPROMArray that presents several EEPROMs as one linear sequence of pages.
+ * Consecutive pages are striped across the chips (page n is on chip n % chip_count), so that the
+ * write cycle of one chip overlaps with the page loads of the others.
+ * @param chips Pointer to an array of EEPROMs, in stripe order.
+ * @param chip_count The number of EEPROMs (1 to EEPROM_ARRAY_MAX_CHIPS). Extra chips are ignored. An
+ * array without chips has no pages, so all of its page reads and writes fail with HAL_ERROR.
+ */
+EEPROMArray::EEPROMArray(EEPROM *const *chips, uint8_t chip_count)
+{
+    if (chip_count > EEPROM_ARRAY_MAX_CHIPS)
+    {
+        chip_count = EEPROM_ARRAY_MAX_CHIPS;
+    }
+
+    for (uint8_t i = 0; i < chip_count; i++)
+    {
+        this->chips[i] = chips[i];
+    }
+
+    this->chip_count = chip_count;
+}
+
+/**
+ * @brief Retrieves the number of EEPROMs in the array.
+ * @return The chip count.
+ */
+uint8_t EEPROMArray::getChipCount()
+{
+    return this->chip_count;
+}
+
+/**
+ * @brief Retrieves an EEPROM of the array.
+ * @param chip_index The index of the EEPROM (0 to chip count - 1).
+ * @return Pointer to the EEPROM, or nullptr if the index is out of range.
+ */
+EEPROM *EEPROMArray::getChip(uint8_t chip_index)
+{
+    if (chip_index >= this->chip_count)
+    {
+        return nullptr;
+    }
+
+    return this->chips[chip_index];
+}
+
+/**
+ * @brief Retrieves the total number of pages of all EEPROMs.
+ * @return The page count.
+ */
+uint16_t EEPROMArray::getPageCount()
+{
+    return this->chip_count * EEPROM_PAGES_PER_CHIP;
+}
+
+/**
+ * @brief Retrieves the total capacity of all EEPROMs.
+ * @return The capacity in bytes.
+ */
+uint32_t EEPROMArray::getSize()
+{
+    return this->chip_count * EEPROM_SIZE;
+}
+
+/**
+ * @brief Retrieves the EEPROM that holds a page.
+ * @param page_index The index of the page (0 to page count - 1).
+ * @return Pointer to the EEPROM, or nullptr if the array has no chips.
+ */
+EEPROM *EEPROMArray::getChipForPage(uint16_t page_index)
+{
+    if (this->chip_count == 0)
+    {
+        return nullptr;
+    }
+
+    return this->chips[page_index % this->chip_count];
+}
+
+/**
+ * @brief Retrieves the memory address of a page on the EEPROM that holds it.
+ * @param page_index The index of the page (0 to page count - 1).
+ * @return The 16-bit memory address of the first byte of the page, or 0 if the array has no chips.
+ */
+uint16_t EEPROMArray::getChipAddressForPage(uint16_t page_index)
+{
+    if (this->chip_count == 0)
+    {
+        return 0;
+    }
+
+    return (page_index / this->chip_count) * EEPROM_PAGE_SIZE;
+}
+
+/**
+ * @brief Writes data to the start of a page. Only the EEPROM holding the page waits for its previous
+ * write cycle, so writes to consecutive pages do not wait for each other.
+ * @param page_index The index of the page (0 to page count - 1).
+ * @param data Pointer to the data to be written.
+ * @param length The number of bytes to write (1 to EEPROM_PAGE_SIZE).
+ * @return The HAL status of the page write, or HAL_ERROR if the page index is out of range.
+ */
+HAL_StatusTypeDef EEPROMArray::writePage(uint16_t page_index, const uint8_t *data, uint16_t length)
+{
+    if (page_index >= this->getPageCount())
+    {
+        return HAL_ERROR;
+    }
+
+    return this->getChipForPage(page_index)->writePage(this->getChipAddressForPage(page_index), data, length);
+}
+
+/**
+ * @brief Reads data from the start of a page.
+ * @param page_index The index of the page (0 to page count - 1).
+ * @param buffer Pointer to a buffer where the read data will be stored.
+ * @param length The number of bytes to read (1 to EEPROM_PAGE_SIZE).
+ * @return The HAL status of the read, or HAL_ERROR if the page index or length is out of range.
+ */
+HAL_StatusTypeDef EEPROMArray::readPage(uint16_t page_index, uint8_t *buffer, uint16_t length)
+{
+    if (page_index >= this->getPageCount() || length > EEPROM_PAGE_SIZE)
+    {
+        return HAL_ERROR;
+    }
+
+    return this->getChipForPage(page_index)->readRange(this->getChipAddressForPage(page_index), buffer, length);
+}
@@ -0,0 +1,400 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file EEPROMAsync.cpp
+ * @brief Implementation file for the EEPROMAsync class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <string.h>
+
+#include "EEPROMAsync.h"
+#include "project_utility.h"
+
+using utility::getI2CWriteAddress;
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs an EEPROMAsync that sends queued page writes via DMA on the specified I2C bus
+ * and registers it for the HAL I2C callbacks of that bus. If all instance slots are taken by other
+ * buses, the writer stays unregistered and submitPageWrite fails with HAL_ERROR.
+ * @param i2c_handle Pointer to the I2C handle used for communication. DMA must be linked to its TX channel.
+ */
+EEPROMAsync::EEPROMAsync(I2C_HandleTypeDef *i2c_handle) : i2c_handle(i2c_handle)
+{
+    this->queue_head = 0;
+    this->queue_count = 0;
+    this->transfer_in_progress = false;
+    this->transfer_index = 0;
+    this->completion_callback = nullptr;
+    this->completion_context = nullptr;
+
+    for (EEPROMAsync *&instance : instances)
+    {
+        if (instance == nullptr || instance->i2c_handle == i2c_handle)
+        {
+            instance = this;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Sets the function called once a page write has completed or failed.
+ * @param callback The completion function, or nullptr to disable the hook.
+ * @param context Pointer passed through to the completion function.
+ */
+void EEPROMAsync::setCompletionCallback(EEPROMWriteCompleteCallback callback, void *context)
+{
+    this->completion_callback = callback;
+    this->completion_context = context;
+}
+
+/**
+ * @brief Queues a page write and starts it right away if the bus is free. The data is copied, so
+ * the caller may reuse its buffer as soon as the call returns.
+ * @param eeprom Pointer to the EEPROM to write to.
+ * @param memory_address The 16-bit valid memory address (0x0000 to 0x7FFF) of the first byte to write.
+ * @param data Pointer to the data to be written to the EEPROM.
+ * @param length The number of bytes to write (1 to EEPROM_PAGE_SIZE, not crossing a page boundary).
+ * @return HAL_OK if the write was queued, HAL_BUSY if the queue is full, or HAL_ERROR if the
+ * arguments are invalid or the writer is not registered for the HAL I2C callbacks of its bus.
+ */
+HAL_StatusTypeDef EEPROMAsync::submitPageWrite(EEPROM *eeprom, uint16_t memory_address, const uint8_t *data, uint16_t length)
+{
+    if (eeprom == nullptr || data == nullptr || length == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    // Without the transfer callbacks, the first transfer would never be seen to complete
+    if (getInstance(this->i2c_handle) != this)
+    {
+        return HAL_ERROR;
+    }
+
+    if (memory_address > EEPROM_MAX_ADDRESS || (memory_address % EEPROM_PAGE_SIZE) + length > EEPROM_PAGE_SIZE)
+    {
+        return HAL_ERROR;
+    }
+
+    if (this->queue_count == EEPROM_ASYNC_QUEUE_SIZE)
+    {
+        return HAL_BUSY;
+    }
+
+    WriteRequest &request = this->queue[(this->queue_head + this->queue_count) % EEPROM_ASYNC_QUEUE_SIZE];
+    request.eeprom = eeprom;
+    request.memory_address = memory_address;
+    request.length = length;
+    request.state = State::Queued;
+    request.retry_count = 0;
+    eeprom->buildAddressBuffer(request.buffer, memory_address);
+    memcpy(&request.buffer[2], data, length);
+    this->queue_count++;
+
+    this->service();
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Advances the queued page writes without blocking. Detects the end of each write cycle by a
+ * single ACK poll, sends a write whose transfer failed again up to EEPROM_ASYNC_MAX_RETRIES times,
+ * reports completed or failed writes to the completion hook in the order they were submitted, and
+ * starts the next DMA transfer once the bus is free. A write to one EEPROM starts
+ * while others are still in their write cycle, so writes striped across several chips overlap.
+ * Call this regularly from the main loop.
+ */
+void EEPROMAsync::service()
+{
+    if (this->transfer_in_progress)
+    {
+        return;
+    }
+
+    // Poll every write cycle in progress, so that each one is timed when it ends, and queue failed transfers
+    // again; a retried write is older than every request not yet sent, so it is sent before any later write
+    // to the same page
+    for (uint8_t i = 0; i < this->queue_count; i++)
+    {
+        WriteRequest &request = this->queue[(this->queue_head + i) % EEPROM_ASYNC_QUEUE_SIZE];
+
+        if (request.state == State::WriteCycle)
+        {
+            request.eeprom->isWriteComplete();
+        }
+        else if (request.state == State::TransferError && request.retry_count < EEPROM_ASYNC_MAX_RETRIES)
+        {
+            request.retry_count++;
+            request.state = State::Queued;
+        }
+    }
+
+    while (this->queue_count > 0)
+    {
+        WriteRequest &request = this->queue[this->queue_head];
+
+        if (request.state == State::TransferError)
+        {
+            this->completeRequest(HAL_ERROR);
+        }
+        else if (request.state == State::WriteCycle && request.eeprom->isWriteComplete())
+        {
+            this->completeRequest(HAL_OK);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // Start the oldest request that has not been sent yet
+    for (uint8_t i = 0; i < this->queue_count; i++)
+    {
+        uint8_t queue_index = (this->queue_head + i) % EEPROM_ASYNC_QUEUE_SIZE;
+
+        if (this->queue[queue_index].state == State::Queued)
+        {
+            HAL_StatusTypeDef status = this->startTransfer(queue_index);
+
+            if (status != HAL_OK && status != HAL_BUSY)
+            {
+                this->queue[queue_index].state = State::TransferError;
+            }
+
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Checks whether all queued page writes have completed.
+ * @return True if the queue is empty, false otherwise.
+ */
+bool EEPROMAsync::isIdle()
+{
+    return this->queue_count == 0;
+}
+
+/**
+ * @brief Checks whether a DMA transfer currently occupies the bus. Other devices on the bus can be
+ * accessed during the write cycle that follows the transfer.
+ * @return True if a transfer is in progress, false otherwise.
+ */
+bool EEPROMAsync::isTransferInProgress()
+{
+    return this->transfer_in_progress;
+}
+
+/**
+ * @brief Retrieves the number of page writes that have not completed yet, including the one in flight.
+ * @return The number of pending page writes.
+ */
+uint8_t EEPROMAsync::getPendingCount()
+{
+    return this->queue_count;
+}
+
+/**
+ * @brief Blocks until the current DMA transfer has released the bus, without starting a new one.
+ * @param timeout_ms The maximum time to wait in milliseconds.
+ * @return HAL_OK once the bus is free, or HAL_TIMEOUT if it is not within the timeout.
+ */
+HAL_StatusTypeDef EEPROMAsync::waitForTransferComplete(uint32_t timeout_ms)
+{
+    uint32_t start_ms = HAL_GetTick();
+
+    while (this->transfer_in_progress)
+    {
+        if (HAL_GetTick() - start_ms > timeout_ms)
+        {
+            return HAL_TIMEOUT;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Blocks until all queued page writes, including their write cycles, have completed.
+ * @param timeout_ms The maximum time to wait in milliseconds.
+ * @return HAL_OK once the queue is empty, or HAL_TIMEOUT if it is not within the timeout.
+ */
+HAL_StatusTypeDef EEPROMAsync::waitUntilIdle(uint32_t timeout_ms)
+{
+    uint32_t start_ms = HAL_GetTick();
+
+    while (!this->isIdle())
+    {
+        if (HAL_GetTick() - start_ms > timeout_ms)
+        {
+            return HAL_TIMEOUT;
+        }
+
+        this->service();
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Handles the end of a DMA transfer. The EEPROM starts its internal write cycle as soon as
+ * the STOP condition is sent, so the write cycle timing starts here. Called in interrupt context.
+ */
+void EEPROMAsync::handleTransferComplete()
+{
+    if (!this->transfer_in_progress)
+    {
+        return;
+    }
+
+    WriteRequest &request = this->queue[this->transfer_index];
+    request.eeprom->startWriteCycle();
+    request.state = State::WriteCycle;
+    this->transfer_in_progress = false;
+}
+
+/**
+ * @brief Handles a failed DMA transfer. The failure is reported by the next call to service.
+ * Called in interrupt context.
+ */
+void EEPROMAsync::handleTransferError()
+{
+    if (!this->transfer_in_progress)
+    {
+        return;
+    }
+
+    this->queue[this->transfer_index].state = State::TransferError;
+    this->transfer_in_progress = false;
+}
+
+/**
+ * @brief Retrieves the EEPROMAsync registered for an I2C bus.
+ * @param i2c_handle Pointer to the I2C handle of the bus.
+ * @return Pointer to the registered EEPROMAsync, or nullptr if there is none.
+ */
+EEPROMAsync *EEPROMAsync::getInstance(I2C_HandleTypeDef *i2c_handle)
+{
+    for (EEPROMAsync *instance : instances)
+    {
+        if (instance != nullptr && instance->i2c_handle == i2c_handle)
+        {
+            return instance;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Starts the DMA transfer of a queued page write.
+ * @param queue_index The index of the request in the queue.
+ * @return HAL_OK if the transfer was started, HAL_BUSY if the bus or the target EEPROM is not ready
+ * yet, or the HAL status of the failed DMA start.
+ */
+HAL_StatusTypeDef EEPROMAsync::startTransfer(uint8_t queue_index)
+{
+    WriteRequest &request = this->queue[queue_index];
+
+    if (HAL_I2C_GetState(this->i2c_handle) != HAL_I2C_STATE_READY)
+    {
+        return HAL_BUSY;
+    }
+
+    // A previous write to the same EEPROM may still be in its write cycle
+    if (!request.eeprom->isWriteComplete())
+    {
+        return HAL_BUSY;
+    }
+
+    // Set before starting the transfer, since the completion interrupt may fire right away
+    request.state = State::Transferring;
+    this->transfer_index = queue_index;
+    this->transfer_in_progress = true;
+
+    HAL_StatusTypeDef status = HAL_I2C_Master_Transmit_DMA(
+        this->i2c_handle,
+        getI2CWriteAddress(request.eeprom->getI2CAddress()),
+        request.buffer,
+        2 + request.length);
+
+    if (status != HAL_OK)
+    {
+        this->transfer_in_progress = false;
+        request.state = State::Queued;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Removes the oldest page write from the queue and reports it to the completion hook.
+ * @param status The final status of the page write.
+ */
+void EEPROMAsync::completeRequest(HAL_StatusTypeDef status)
+{
+    EEPROM *eeprom = this->queue[this->queue_head].eeprom;
+    uint16_t memory_address = this->queue[this->queue_head].memory_address;
+
+    this->queue_head = (this->queue_head + 1) % EEPROM_ASYNC_QUEUE_SIZE;
+    this->queue_count--;
+
+    if (this->completion_callback != nullptr)
+    {
+        this->completion_callback(eeprom, memory_address, status, this->completion_context);
+    }
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Static_Members Static Members
+ * ------------------------------------------------------------------------------------------------
+ */
+
+EEPROMAsync *EEPROMAsync::instances[3] = {nullptr, nullptr, nullptr};
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section HAL_Callbacks HAL Callbacks
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Overrides the weak HAL callback for a completed master transmit in interrupt or DMA mode.
+ * @param hi2c Pointer to the I2C handle of the bus.
+ */
+extern "C" void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    EEPROMAsync *instance = EEPROMAsync::getInstance(hi2c);
+
+    if (instance != nullptr)
+    {
+        instance->handleTransferComplete();
+    }
+}
+
+/**
+ * @brief Overrides the weak HAL callback for I2C errors in interrupt or DMA mode.
+ * @param hi2c Pointer to the I2C handle of the bus.
+ */
+extern "C" void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    EEPROMAsync *instance = EEPROMAsync::getInstance(hi2c);
+
+    if (instance != nullptr)
+    {
+        instance->handleTransferError();
+    }
+}
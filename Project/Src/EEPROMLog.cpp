@@ -0,0 +1,1400 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file EEPROMLog.cpp
+ * @brief Implementation file for the EEPROMLog class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <string.h>
+
+#include "EEPROMLog.h"
+#include "project_utility.h"
+#include "project_codec.h"
+
+// Log record header fields
+constexpr uint8_t LOG_RECORD_MARKER = 0xA0;
+constexpr uint8_t LOG_RECORD_TAGGED_MARKER = 0xB0;
+constexpr uint8_t LOG_RECORD_MARKER_MASK = 0xF0;
+constexpr uint8_t LOG_RECORD_FORMAT_MASK = 0x0F;
+constexpr uint8_t LOG_ERASED_BYTE = 0xFF;
+
+// Maximum time to wait for queued asynchronous record writes before reading from the EEPROM
+constexpr uint32_t LOG_ASYNC_WRITE_TIMEOUT_MS = 50;
+
+// Width of a sample at the lowest TMP100 resolution (R1R0 = 0b00)
+constexpr uint8_t LOG_MIN_SAMPLE_BIT_WIDTH = 9;
+
+// Largest delta stream code (escape code and a full-width sample)
+constexpr uint8_t LOG_MAX_DELTA_CODE_BITS = 4 + 16;
+
+using codec::calculateCRC16;
+using codec::packBits, codec::unpackBits, codec::unpackSamples;
+using codec::startDeltaStream, codec::appendDeltaSample, codec::decodeDeltaStream;
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs an EEPROMLog that stores samples in page-sized, sequence-stamped records. The
+ * log starts empty at the first record; call recoverHead to resume an existing log.
+ * @param eeprom_array Pointer to the EEPROMs the log is stored in, one record per page.
+ */
+EEPROMLog::EEPROMLog(EEPROMArray *eeprom_array) : eeprom_array(eeprom_array)
+{
+    this->async_writer = nullptr;
+    this->write_result_callback = nullptr;
+    this->write_result_context = nullptr;
+    this->record_count = eeprom_array->getPageCount();
+    this->verify_policy = LogVerifyPolicy::Off;
+    this->verify_pending = false;
+    this->verify_record_index = 0;
+    this->verify_length = 0;
+    this->verify_crc = 0;
+    this->scrub_record_index = 0;
+    this->health_counters = {};
+    this->sample_format = LOG_FORMAT_RAW16;
+    this->sensor_mask = 0;
+    this->closed_record_index = 0;
+    this->closed_record_length = 0;
+    this->closed_record_write_count = 0;
+    this->startRecord(0, 0);
+}
+
+/**
+ * @brief Sets the asynchronous writer used to commit records. Commits then only queue the page write
+ * and return right away. The log takes over the completion callback of the writer: a page write of
+ * the open record that failed on every attempt marks its samples as not committed, so that the next
+ * append or flush writes the record again, like a failed blocking commit. A closed record is kept in
+ * RAM until its page writes have completed and is queued again until it is written. Failed writes
+ * are counted in the health counters. Reads from the EEPROM wait until all queued writes have
+ * completed.
+ * @param async_writer Pointer to the EEPROMAsync of the EEPROM bus, or nullptr to write blocking.
+ */
+void EEPROMLog::setAsyncWriter(EEPROMAsync *async_writer)
+{
+    if (this->async_writer != nullptr)
+    {
+        this->async_writer->setCompletionCallback(nullptr, nullptr);
+    }
+
+    this->async_writer = async_writer;
+
+    if (async_writer != nullptr)
+    {
+        async_writer->setCompletionCallback(handleAsyncWriteResult, this);
+    }
+}
+
+/**
+ * @brief Sets the function called with the result of each asynchronous record write, after the log
+ * has handled it.
+ * @param callback The result function, or nullptr to disable the hook.
+ * @param context Pointer passed through to the result function.
+ */
+void EEPROMLog::setWriteResultCallback(EEPROMWriteCompleteCallback callback, void *context)
+{
+    this->write_result_callback = callback;
+    this->write_result_context = context;
+}
+
+/**
+ * @brief Sets the format of the samples appended from now on. If the current record already holds
+ * samples in another format, it is committed and closed so that each record has a single format.
+ * @param format LOG_FORMAT_RAW16 or LOG_FORMAT_PACKED, combined with the TMP100 resolution bits.
+ * @return The HAL status of the record commit, or HAL_ERROR if the format is invalid.
+ */
+HAL_StatusTypeDef EEPROMLog::setSampleFormat(uint8_t format)
+{
+    if (!this->isFormatValid(format))
+    {
+        return HAL_ERROR;
+    }
+
+    if (format == this->sample_format)
+    {
+        return HAL_OK;
+    }
+
+    if (this->sample_count > 0)
+    {
+        HAL_StatusTypeDef status;
+
+        if (this->sample_count > this->committed_sample_count)
+        {
+            status = this->commitRecord();
+
+            if (status != HAL_OK)
+            {
+                return status;
+            }
+        }
+
+        status = this->retainClosedRecord();
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        this->sample_format = format;
+        this->startRecord((this->record_index + 1) % this->record_count, this->sequence + 1);
+    }
+    else
+    {
+        this->sample_format = format;
+        this->startRecord(this->record_index, this->sequence);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Retrieves the format of the samples in the current record.
+ * @return The sample format.
+ */
+uint8_t EEPROMLog::getSampleFormat()
+{
+    return this->sample_format;
+}
+
+/**
+ * @brief Sets the sensors whose samples are appended from now on, one scan at a time. Records with
+ * a sensor mask are tagged with it; if the current record already holds samples of other sensors,
+ * it is committed and closed so that each record has a single set of sensors.
+ * @param sensor_mask Bit n set for the TMP100 at address 0x48 + n, or 0 for untagged records of a
+ * single sensor.
+ * @return The HAL status of the record commit.
+ */
+HAL_StatusTypeDef EEPROMLog::setSensorMask(uint8_t sensor_mask)
+{
+    if (sensor_mask == this->sensor_mask)
+    {
+        return HAL_OK;
+    }
+
+    if (this->sample_count > 0)
+    {
+        HAL_StatusTypeDef status;
+
+        if (this->sample_count > this->committed_sample_count)
+        {
+            status = this->commitRecord();
+
+            if (status != HAL_OK)
+            {
+                return status;
+            }
+        }
+
+        status = this->retainClosedRecord();
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        this->sensor_mask = sensor_mask;
+        this->startRecord((this->record_index + 1) % this->record_count, this->sequence + 1);
+    }
+    else
+    {
+        this->sensor_mask = sensor_mask;
+        this->startRecord(this->record_index, this->sequence);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Retrieves the sensors whose samples are stored in the current record.
+ * @return The sensor mask, or 0 for untagged records.
+ */
+uint8_t EEPROMLog::getSensorMask()
+{
+    return this->sensor_mask;
+}
+
+/**
+ * @brief Locates the newest record in the EEPROM and resumes appending right after its last sample.
+ * Records of the newest pass through the EEPROM carry consecutive sequence stamps starting at the
+ * first record, so the head is found by a binary search over the record headers (ten header reads
+ * for the 512 records of one 24FC256, one more per doubling of the chip count) instead of a linear
+ * scan. A single bad page among them, left by a record write that failed for good, is bridged by the
+ * record after it, so that the search does not take it for the head and overwrite the newer records.
+ * Only the newest record is read in full and checked against its CRC.
+ * @return The HAL status of the I2C operations.
+ */
+HAL_StatusTypeDef EEPROMLog::recoverHead()
+{
+    HAL_StatusTypeDef status;
+    uint8_t header[LOG_RECORD_HEADER_SIZE];
+
+    status = this->waitForPendingWrites();
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    uint16_t newest_index = 0;
+
+    status = this->readRecordHeader(0, header);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    if (!this->isRecordHeaderValid(header) && this->record_count > 1)
+    {
+        // A bad first page is bridged by the second record like any other bad page
+        newest_index = 1;
+        status = this->readRecordHeader(newest_index, header);
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+    }
+
+    if (!this->isRecordHeaderValid(header))
+    {
+        // Either the log is empty, or the first records were torn right after the log wrapped around
+        status = this->readRecordHeader(this->record_count - 1, header);
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        if (this->isRecordHeaderValid(header))
+        {
+            this->startRecord(0, this->getRecordSequence(header) + 1);
+        }
+        else
+        {
+            this->startRecord(0, 0);
+        }
+
+        return HAL_OK;
+    }
+
+    uint16_t first_sequence = static_cast<uint16_t>(this->getRecordSequence(header) - newest_index);
+    uint16_t oldest_index = this->record_count;
+
+    // Invariant: records [0, newest_index] belong to the newest pass, records [oldest_index, end) do not
+    while (oldest_index - newest_index > 1)
+    {
+        uint16_t middle_index = newest_index + (oldest_index - newest_index) / 2;
+        bool is_newest_pass;
+
+        status = this->checkNewestPassRecord(middle_index, first_sequence, &is_newest_pass);
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        if (is_newest_pass)
+        {
+            newest_index = middle_index;
+        }
+        else
+        {
+            oldest_index = middle_index;
+        }
+    }
+
+    status = this->eeprom_array->readPage(newest_index, this->record_buffer, LOG_RECORD_SIZE);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    uint16_t newest_sequence = static_cast<uint16_t>(first_sequence + newest_index);
+    uint8_t newest_format = this->record_buffer[0] & LOG_RECORD_FORMAT_MASK;
+    uint8_t newest_sensor_mask = this->getRecordSensorMask(this->record_buffer);
+    uint8_t newest_sample_count = this->record_buffer[1];
+
+    if (!this->isRecordIntact(this->record_buffer))
+    {
+        // The newest record was torn by a power loss during its last write, so its samples cannot be trusted
+        this->startRecord(newest_index, newest_sequence);
+    }
+    else
+    {
+        // Keep filling the newest record in place, in the format and for the sensors it was started with
+        this->sample_format = newest_format;
+        this->sensor_mask = newest_sensor_mask;
+        this->record_index = newest_index;
+        this->sequence = newest_sequence;
+        this->sample_count = newest_sample_count;
+        this->committed_sample_count = newest_sample_count;
+
+        if ((newest_format & LOG_FORMAT_ENCODING_MASK) == LOG_FORMAT_DELTA)
+        {
+            // Restore the encoder position by walking the stream
+            decodeDeltaStream(&this->record_buffer[this->getPayloadOffset(newest_sensor_mask)],
+                              this->getPayloadBits(newest_sensor_mask), newest_sample_count, this->getSampleBitWidth(newest_format),
+                              this->getScanLength(newest_sensor_mask), nullptr, &this->delta_state);
+        }
+
+        if (this->isRecordFull())
+        {
+            this->startRecord((newest_index + 1) % this->record_count, newest_sequence + 1);
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Retrieves the number of records the log holds, one per page of the EEPROM array.
+ * @return The record count.
+ */
+uint16_t EEPROMLog::getRecordCount()
+{
+    return this->record_count;
+}
+
+/**
+ * @brief Retrieves the address the next sample will be stored at, counted linearly over the records
+ * of the EEPROM array rather than on a single chip.
+ * @return The 32-bit current write address.
+ */
+uint32_t EEPROMLog::getCurrentWriteAddress()
+{
+    uint16_t bit_offset = this->sample_count * this->getSampleBitWidth(this->sample_format);
+
+    if ((this->sample_format & LOG_FORMAT_ENCODING_MASK) == LOG_FORMAT_DELTA)
+    {
+        bit_offset = this->sample_count > 0 ? this->delta_state.bit_offset : 0;
+    }
+
+    return static_cast<uint32_t>(this->record_index) * LOG_RECORD_SIZE + this->getPayloadOffset(this->sensor_mask) + bit_offset / 8;
+}
+
+/**
+ * @brief Retrieves the index of the record currently being filled.
+ * @return The record index (0 to getRecordCount() - 1).
+ */
+uint16_t EEPROMLog::getCurrentRecordIndex()
+{
+    return this->record_index;
+}
+
+/**
+ * @brief Retrieves the number of samples in the record currently being filled.
+ * @return The sample count.
+ */
+uint8_t EEPROMLog::getCurrentSampleCount()
+{
+    return this->sample_count;
+}
+
+/**
+ * @brief Retrieves the sequence stamp of the record currently being filled.
+ * @return The 16-bit sequence stamp.
+ */
+uint16_t EEPROMLog::getCurrentSequence()
+{
+    return this->sequence;
+}
+
+/**
+ * @brief Appends a sample to the current record, committing the record and starting the next one
+ * once it is full.
+ * @param sample The 16-bit sample to store.
+ * @return The HAL status of the record commit, or HAL_ERROR if the sensor mask selects more than one
+ * sensor. If the commit fails the record stays buffered and the commit is retried on the next append
+ * or flush.
+ */
+HAL_StatusTypeDef EEPROMLog::appendSample(uint16_t sample)
+{
+    if (this->getScanLength(this->sensor_mask) != 1)
+    {
+        return HAL_ERROR;
+    }
+
+    return this->appendScan(&sample);
+}
+
+/**
+ * @brief Appends one sample of each sensor in the sensor mask to the current record. A scan is never
+ * split across records: the record is committed and the next one started once it cannot take
+ * another full scan.
+ * @param samples Pointer to one 16-bit sample per sensor, in ascending address order.
+ * @return The HAL status of the record commit. If the commit fails the record stays buffered and
+ * the commit is retried on the next append or flush.
+ */
+HAL_StatusTypeDef EEPROMLog::appendScan(const uint16_t *samples)
+{
+    if (samples == nullptr)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status;
+
+    if (this->isRecordFull())
+    {
+        status = this->flush();
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+    }
+
+    uint8_t scan_length = this->getScanLength(this->sensor_mask);
+    uint8_t *payload = &this->record_buffer[this->getPayloadOffset(this->sensor_mask)];
+
+    for (uint8_t i = 0; i < scan_length; i++)
+    {
+        this->encodeSample(this->sample_format, this->sensor_mask, payload, this->sample_count, samples[i]);
+        this->sample_count++;
+    }
+
+    if (this->isRecordFull())
+    {
+        return this->flush();
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Writes the samples of the current record that are not yet stored in the EEPROM. A partial
+ * record is rewritten in place by later flushes; a full record is closed and the next one started.
+ * @return The HAL status of the page write.
+ */
+HAL_StatusTypeDef EEPROMLog::flush()
+{
+    HAL_StatusTypeDef status;
+
+    if (this->sample_count > this->committed_sample_count)
+    {
+        status = this->commitRecord();
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+    }
+
+    if (this->isRecordFull())
+    {
+        status = this->retainClosedRecord();
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        this->startRecord((this->record_index + 1) % this->record_count, this->sequence + 1);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reads a single sample from the log, serving samples of the current record from RAM so that
+ * reads are consistent with all previous appends.
+ * @param record_index The index of the record (0 to getRecordCount() - 1).
+ * @param sample_index The index of the sample within the record.
+ * @param sample Pointer to a 16-bit variable where the raw sample will be stored.
+ * @return The HAL status of the read. Returns HAL_ERROR if the record is empty, corrupt, or torn, or
+ * if it holds fewer samples.
+ */
+HAL_StatusTypeDef EEPROMLog::readSample(uint16_t record_index, uint8_t sample_index, uint16_t *sample)
+{
+    if (sample == nullptr)
+    {
+        return HAL_ERROR;
+    }
+
+    if (record_index == this->record_index)
+    {
+        if (sample_index >= this->sample_count)
+        {
+            return HAL_ERROR;
+        }
+
+        *sample = this->decodeSample(this->sample_format, this->sensor_mask,
+                                     &this->record_buffer[this->getPayloadOffset(this->sensor_mask)], sample_index);
+        return HAL_OK;
+    }
+
+    HAL_StatusTypeDef status;
+    LogRecord record;
+
+    status = this->readRecord(record_index, &record);
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    if (sample_index >= record.sample_count)
+    {
+        return HAL_ERROR;
+    }
+
+    *sample = this->decodeSample(record.format, record.sensor_mask, record.payload, sample_index);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reads a record from the EEPROM and checks its header and CRC.
+ * @param record_index The index of the record (0 to getRecordCount() - 1).
+ * @param record Pointer to a LogRecord where the decoded record will be stored.
+ * @return The HAL status of the read. Returns HAL_ERROR if the record is empty, corrupt, or was torn
+ * by a power loss during its write.
+ */
+HAL_StatusTypeDef EEPROMLog::readRecord(uint16_t record_index, LogRecord *record)
+{
+    if (record_index >= this->record_count || record == nullptr)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status;
+    uint8_t buffer[LOG_RECORD_SIZE];
+
+    status = this->waitForPendingWrites();
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    status = this->eeprom_array->readPage(record_index, buffer, sizeof(buffer));
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    if (!this->decodeRecord(record_index, buffer, record))
+    {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reads every record once, oldest first, and passes each intact record to a callback. Empty,
+ * corrupt, and torn records are skipped and counted. Samples that have not been flushed yet are
+ * not included.
+ * @param callback Function called for each intact record.
+ * @param context Pointer passed through to the callback.
+ * @param result Pointer to a LogScanResult where the record counts will be stored.
+ * @return The HAL status of the reads.
+ */
+HAL_StatusTypeDef EEPROMLog::scanRecords(LogRecordCallback callback, void *context, LogScanResult *result)
+{
+    if (callback == nullptr || result == nullptr)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status;
+    uint8_t buffer[LOG_RECORD_SIZE];
+    LogRecord record;
+    *result = {};
+
+    status = this->waitForPendingWrites();
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    // The record after the one being filled is the oldest one still stored
+    for (uint16_t i = 1; i <= this->record_count; i++)
+    {
+        uint16_t record_index = (this->record_index + i) % this->record_count;
+
+        if (record_index == this->record_index && this->committed_sample_count == 0)
+        {
+            // The page of the record being filled still holds a record of the previous pass
+            continue;
+        }
+
+        status = this->eeprom_array->readPage(record_index, buffer, sizeof(buffer));
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        if (this->decodeRecord(record_index, buffer, &record))
+        {
+            result->valid_record_count++;
+            callback(record, context);
+        }
+        else if (buffer[0] == LOG_ERASED_BYTE && buffer[1] == LOG_ERASED_BYTE)
+        {
+            result->empty_record_count++;
+        }
+        else
+        {
+            result->corrupt_record_count++;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Decodes all samples of a record into raw 16-bit register values, so that callers do not
+ * depend on the format the record was stored in. Samples of tagged records are interleaved by scan,
+ * one per sensor of record.sensor_mask in ascending address order.
+ * @param record The decoded record.
+ * @param samples Pointer to an array of LOG_RECORD_MAX_SAMPLES values where the samples will be stored.
+ * @return The number of samples stored.
+ */
+uint8_t EEPROMLog::decodeSamples(const LogRecord &record, uint16_t *samples)
+{
+    uint8_t encoding = record.format & LOG_FORMAT_ENCODING_MASK;
+
+    if (encoding == LOG_FORMAT_PACKED || encoding == LOG_FORMAT_DELTA)
+    {
+        uint8_t bit_width = this->getSampleBitWidth(record.format);
+
+        if (encoding == LOG_FORMAT_PACKED)
+        {
+            unpackSamples(record.payload, record.sample_count, bit_width, samples);
+        }
+        else
+        {
+            decodeDeltaStream(record.payload, this->getPayloadBits(record.sensor_mask), record.sample_count, bit_width,
+                              this->getScanLength(record.sensor_mask), samples, nullptr);
+        }
+
+        for (uint8_t i = 0; i < record.sample_count; i++)
+        {
+            samples[i] <<= 16 - bit_width;
+        }
+    }
+    else
+    {
+        for (uint8_t i = 0; i < record.sample_count; i++)
+        {
+            samples[i] = this->decodeSample(record.format, record.sensor_mask, record.payload, i);
+        }
+    }
+
+    return record.sample_count;
+}
+
+/**
+ * @brief Sets how the records written to the EEPROM are verified in the background.
+ * @param policy The verification policy.
+ */
+void EEPROMLog::setVerifyPolicy(LogVerifyPolicy policy)
+{
+    this->verify_policy = policy;
+    this->verify_pending = false;
+}
+
+/**
+ * @brief Performs one background verification step according to the verification policy: reads
+ * back the last committed page (PerPage) or the next stored record (PeriodicScrub). Failures are
+ * counted in the health counters. Call this from an idle slot of the main loop.
+ * @return The HAL status of the read, or HAL_BUSY if a queued asynchronous write has not completed
+ * yet and the step should be retried in a later slot.
+ */
+HAL_StatusTypeDef EEPROMLog::runVerificationSlot()
+{
+    if (this->verify_policy == LogVerifyPolicy::Off)
+    {
+        return HAL_OK;
+    }
+
+    // Do not block on background writes; the page is checked in a later slot instead
+    if (this->async_writer != nullptr && !this->async_writer->isIdle())
+    {
+        return HAL_BUSY;
+    }
+
+    if (this->verify_policy == LogVerifyPolicy::PerPage)
+    {
+        return this->verifyCommittedPage();
+    }
+
+    return this->scrubNextRecord();
+}
+
+/**
+ * @brief Retrieves the results of the background verification.
+ * @return Reference to the health counters.
+ */
+const LogHealthCounters &EEPROMLog::getHealthCounters()
+{
+    return this->health_counters;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Reads the header of a record from the EEPROM.
+ * @param record_index The index of the record (0 to getRecordCount() - 1).
+ * @param header Pointer to a buffer of LOG_RECORD_HEADER_SIZE bytes where the header will be stored.
+ * @return The HAL status of the read.
+ */
+HAL_StatusTypeDef EEPROMLog::readRecordHeader(uint16_t record_index, uint8_t *header)
+{
+    return this->eeprom_array->readPage(record_index, header, LOG_RECORD_HEADER_SIZE);
+}
+
+/**
+ * @brief Checks whether a record belongs to the newest pass through the EEPROM, i.e. carries the
+ * sequence stamp first_sequence + record_index. A record that does not is still counted as part of
+ * the newest pass if the following record is, so that a single bad page does not end the pass.
+ * @param record_index The index of the record (0 to getRecordCount() - 1).
+ * @param first_sequence The sequence stamp of the first record of the newest pass.
+ * @param is_newest_pass Pointer to a variable where the result will be stored.
+ * @return The HAL status of the header reads.
+ */
+HAL_StatusTypeDef EEPROMLog::checkNewestPassRecord(uint16_t record_index, uint16_t first_sequence, bool *is_newest_pass)
+{
+    uint8_t header[LOG_RECORD_HEADER_SIZE];
+
+    *is_newest_pass = false;
+
+    for (uint16_t i = record_index; i <= record_index + 1 && i < this->record_count; i++)
+    {
+        HAL_StatusTypeDef status = this->readRecordHeader(i, header);
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+
+        if (this->isRecordHeaderValid(header) && this->getRecordSequence(header) == static_cast<uint16_t>(first_sequence + i))
+        {
+            *is_newest_pass = true;
+            break;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Checks whether a sample format is supported by the log.
+ * @param format The sample format.
+ * @return True if the format is valid, false otherwise.
+ */
+bool EEPROMLog::isFormatValid(uint8_t format)
+{
+    if (format & ~LOG_RECORD_FORMAT_MASK)
+    {
+        return false;
+    }
+
+    uint8_t encoding = format & LOG_FORMAT_ENCODING_MASK;
+    return encoding == LOG_FORMAT_RAW16 || encoding == LOG_FORMAT_PACKED || encoding == LOG_FORMAT_DELTA;
+}
+
+/**
+ * @brief Retrieves the number of bits a sample occupies in the payload.
+ * @param format The sample format.
+ * @return 16 for raw samples, or 9 to 12 for packed and delta samples depending on the resolution.
+ */
+uint8_t EEPROMLog::getSampleBitWidth(uint8_t format)
+{
+    if ((format & LOG_FORMAT_ENCODING_MASK) != LOG_FORMAT_RAW16)
+    {
+        return LOG_MIN_SAMPLE_BIT_WIDTH + (format & LOG_FORMAT_RESOLUTION_MASK);
+    }
+
+    return 16;
+}
+
+/**
+ * @brief Retrieves the number of samples in a scan, one per sensor of a sensor mask.
+ * @param sensor_mask The sensor mask, or 0 for untagged records.
+ * @return The scan length (1 to LOG_MAX_SENSORS).
+ */
+uint8_t EEPROMLog::getScanLength(uint8_t sensor_mask)
+{
+    if (sensor_mask == 0)
+    {
+        return 1;
+    }
+
+    return __builtin_popcount(sensor_mask);
+}
+
+/**
+ * @brief Retrieves the offset of the payload within a record, which follows the sensor tag in
+ * tagged records.
+ * @param sensor_mask The sensor mask of the record, or 0 for untagged records.
+ * @return The payload offset in bytes.
+ */
+uint8_t EEPROMLog::getPayloadOffset(uint8_t sensor_mask)
+{
+    if (sensor_mask == 0)
+    {
+        return LOG_RECORD_HEADER_SIZE;
+    }
+
+    return LOG_RECORD_HEADER_SIZE + LOG_RECORD_SENSOR_TAG_SIZE;
+}
+
+/**
+ * @brief Retrieves the size of the payload of a record in bits, the capacity of a delta stream.
+ * @param sensor_mask The sensor mask of the record, or 0 for untagged records.
+ * @return The payload size in bits.
+ */
+uint16_t EEPROMLog::getPayloadBits(uint8_t sensor_mask)
+{
+    return (LOG_RECORD_SIZE - this->getPayloadOffset(sensor_mask)) * 8;
+}
+
+/**
+ * @brief Extracts the sensor mask from a raw record.
+ * @param record Pointer to the record (LOG_RECORD_SIZE bytes).
+ * @return The sensor mask of a tagged record, or 0 for an untagged record.
+ */
+uint8_t EEPROMLog::getRecordSensorMask(const uint8_t *record)
+{
+    if ((record[0] & LOG_RECORD_MARKER_MASK) != LOG_RECORD_TAGGED_MARKER)
+    {
+        return 0;
+    }
+
+    return record[LOG_RECORD_HEADER_SIZE];
+}
+
+/**
+ * @brief Retrieves the number of samples that fit into the payload of a record, rounded down to
+ * whole scans. Delta records are only limited by the sample count byte, but usually fill their
+ * payload first.
+ * @param format The sample format.
+ * @param sensor_mask The sensor mask of the record, or 0 for untagged records.
+ * @return The maximum sample count.
+ */
+uint8_t EEPROMLog::getMaxSampleCount(uint8_t format, uint8_t sensor_mask)
+{
+    uint8_t scan_length = this->getScanLength(sensor_mask);
+    uint8_t max_sample_count = LOG_RECORD_MAX_SAMPLES;
+
+    if ((format & LOG_FORMAT_ENCODING_MASK) != LOG_FORMAT_DELTA)
+    {
+        max_sample_count = this->getPayloadBits(sensor_mask) / this->getSampleBitWidth(format);
+    }
+
+    return max_sample_count - max_sample_count % scan_length;
+}
+
+/**
+ * @brief Calculates the number of payload bytes used by the samples of a record. The length of a
+ * delta stream depends on its contents and is found by walking the stream.
+ * @param record Pointer to the record (LOG_RECORD_SIZE bytes).
+ * @return The used payload length in bytes, including a partially used last byte.
+ */
+uint16_t EEPROMLog::getPayloadLength(const uint8_t *record)
+{
+    uint8_t format = record[0] & LOG_RECORD_FORMAT_MASK;
+    uint8_t sensor_mask = this->getRecordSensorMask(record);
+    uint8_t sample_count = record[1];
+    uint8_t bit_width = this->getSampleBitWidth(format);
+
+    if ((format & LOG_FORMAT_ENCODING_MASK) == LOG_FORMAT_DELTA)
+    {
+        DeltaStreamState state;
+        decodeDeltaStream(&record[this->getPayloadOffset(sensor_mask)], this->getPayloadBits(sensor_mask), sample_count, bit_width,
+                          this->getScanLength(sensor_mask), nullptr, &state);
+        return (state.bit_offset + 7) / 8;
+    }
+
+    return (sample_count * bit_width + 7) / 8;
+}
+
+/**
+ * @brief Checks whether the current record can take another scan. A delta record is full once the
+ * largest possible code for each sample of a scan no longer fits into its payload.
+ * @return True if the record is full, false otherwise.
+ */
+bool EEPROMLog::isRecordFull()
+{
+    uint8_t scan_length = this->getScanLength(this->sensor_mask);
+
+    if (this->sample_count + scan_length > this->getMaxSampleCount(this->sample_format, this->sensor_mask))
+    {
+        return true;
+    }
+
+    if ((this->sample_format & LOG_FORMAT_ENCODING_MASK) == LOG_FORMAT_DELTA && this->sample_count > 0)
+    {
+        return this->delta_state.bit_offset + scan_length * LOG_MAX_DELTA_CODE_BITS > this->getPayloadBits(this->sensor_mask);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Stores a raw 16-bit register value in a payload. Packed samples keep only the significant,
+ * left-justified bits of the register; the always-zero low bits are dropped.
+ * @param format The sample format.
+ * @param sensor_mask The sensor mask of the record, or 0 for untagged records.
+ * @param payload Pointer to the record payload.
+ * @param sample_index The index of the sample within the record.
+ * @param sample The raw 16-bit register value.
+ */
+void EEPROMLog::encodeSample(uint8_t format, uint8_t sensor_mask, uint8_t *payload, uint8_t sample_index, uint16_t sample)
+{
+    uint8_t bit_width = this->getSampleBitWidth(format);
+
+    if ((format & LOG_FORMAT_ENCODING_MASK) == LOG_FORMAT_DELTA)
+    {
+        if (sample_index == 0)
+        {
+            // Each sensor is predicted from its own previous sample
+            startDeltaStream(payload, sample >> (16 - bit_width), bit_width, this->getScanLength(sensor_mask), &this->delta_state);
+        }
+        else
+        {
+            // Cannot fail, isRecordFull leaves room for the largest code of every sample of a scan
+            appendDeltaSample(payload, this->getPayloadBits(sensor_mask), sample >> (16 - bit_width), bit_width, &this->delta_state);
+        }
+
+        return;
+    }
+
+    packBits(payload, sample_index * bit_width, sample >> (16 - bit_width), bit_width);
+}
+
+/**
+ * @brief Restores a raw 16-bit register value from a payload.
+ * @param format The sample format.
+ * @param sensor_mask The sensor mask of the record, or 0 for untagged records.
+ * @param payload Pointer to the record payload.
+ * @param sample_index The index of the sample within the record.
+ * @return The raw 16-bit register value.
+ */
+uint16_t EEPROMLog::decodeSample(uint8_t format, uint8_t sensor_mask, const uint8_t *payload, uint8_t sample_index)
+{
+    uint8_t bit_width = this->getSampleBitWidth(format);
+
+    if ((format & LOG_FORMAT_ENCODING_MASK) == LOG_FORMAT_DELTA)
+    {
+        // Delta samples depend on all earlier samples of the record
+        DeltaStreamState state;
+        decodeDeltaStream(payload, this->getPayloadBits(sensor_mask), sample_index + 1, bit_width, this->getScanLength(sensor_mask),
+                          nullptr, &state);
+        return state.previous_value << (16 - bit_width);
+    }
+
+    return unpackBits(payload, sample_index * bit_width, bit_width) << (16 - bit_width);
+}
+
+/**
+ * @brief Checks whether a header belongs to a record written by the log. Erased EEPROM cells read
+ * as 0xFF and never carry the header marker. The sensor tag follows the header and is checked
+ * together with the CRC.
+ * @param header Pointer to the record header.
+ * @return True if the header is valid, false otherwise.
+ */
+bool EEPROMLog::isRecordHeaderValid(const uint8_t *header)
+{
+    uint8_t marker = header[0] & LOG_RECORD_MARKER_MASK;
+
+    if (marker != LOG_RECORD_MARKER && marker != LOG_RECORD_TAGGED_MARKER)
+    {
+        return false;
+    }
+
+    uint8_t format = header[0] & LOG_RECORD_FORMAT_MASK;
+
+    if (!this->isFormatValid(format))
+    {
+        return false;
+    }
+
+    // Untagged records hold the most samples of any sensor mask
+    return header[1] > 0 && header[1] <= this->getMaxSampleCount(format, 0);
+}
+
+/**
+ * @brief Extracts the sequence stamp from a record header.
+ * @param header Pointer to the record header.
+ * @return The 16-bit sequence stamp.
+ */
+uint16_t EEPROMLog::getRecordSequence(const uint8_t *header)
+{
+    return (header[2] << 8) | header[3];
+}
+
+/**
+ * @brief Calculates the CRC of a record over its first four header bytes, its sensor tag, and the
+ * used part of its payload, so that unused payload bytes left over from older records do not matter.
+ * @param record Pointer to the record (LOG_RECORD_SIZE bytes).
+ * @return The 16-bit CRC.
+ */
+uint16_t EEPROMLog::calculateRecordCRC(const uint8_t *record)
+{
+    uint8_t payload_offset = this->getPayloadOffset(this->getRecordSensorMask(record));
+    uint16_t payload_length = this->getPayloadLength(record);
+
+    if (payload_length > LOG_RECORD_SIZE - payload_offset)
+    {
+        payload_length = LOG_RECORD_SIZE - payload_offset;
+    }
+
+    uint16_t crc = calculateCRC16(record, 4);
+    return calculateCRC16(&record[LOG_RECORD_HEADER_SIZE], payload_offset - LOG_RECORD_HEADER_SIZE + payload_length, crc);
+}
+
+/**
+ * @brief Checks whether the CRC stored in a record matches its contents. A mismatch indicates a
+ * corrupt record or one that was torn by a power loss during its write.
+ * @param record Pointer to the record (LOG_RECORD_SIZE bytes).
+ * @return True if the CRC matches, false otherwise.
+ */
+bool EEPROMLog::isRecordIntact(const uint8_t *record)
+{
+    if ((record[0] & LOG_RECORD_MARKER_MASK) == LOG_RECORD_TAGGED_MARKER &&
+        (record[LOG_RECORD_HEADER_SIZE] == 0 || record[1] % this->getScanLength(record[LOG_RECORD_HEADER_SIZE]) != 0))
+    {
+        // A tagged record always holds whole scans of at least one sensor
+        return false;
+    }
+
+    uint16_t stored_crc = (record[4] << 8) | record[5];
+    return stored_crc == this->calculateRecordCRC(record);
+}
+
+/**
+ * @brief Checks the header and CRC of a raw record and decodes it.
+ * @param record_index The index the record was read from.
+ * @param buffer Pointer to the raw record (LOG_RECORD_SIZE bytes).
+ * @param record Pointer to a LogRecord where the decoded record will be stored.
+ * @return True if the record is intact, false if it is empty, corrupt, or torn.
+ */
+bool EEPROMLog::decodeRecord(uint16_t record_index, const uint8_t *buffer, LogRecord *record)
+{
+    if (!this->isRecordHeaderValid(buffer) || !this->isRecordIntact(buffer))
+    {
+        return false;
+    }
+
+    record->record_index = record_index;
+    record->sequence = this->getRecordSequence(buffer);
+    record->format = buffer[0] & LOG_RECORD_FORMAT_MASK;
+    record->sensor_mask = this->getRecordSensorMask(buffer);
+    record->sample_count = buffer[1];
+
+    uint8_t payload_offset = this->getPayloadOffset(record->sensor_mask);
+    memset(record->payload, 0, LOG_RECORD_PAYLOAD_SIZE);
+    memcpy(record->payload, &buffer[payload_offset], LOG_RECORD_SIZE - payload_offset);
+
+    return true;
+}
+
+/**
+ * @brief Waits until all record writes queued on the asynchronous writer have completed, so that
+ * reads return the committed data and do not collide with a DMA transfer on the bus.
+ * @return HAL_OK if no writes are pending, or HAL_TIMEOUT if they do not complete in time.
+ */
+HAL_StatusTypeDef EEPROMLog::waitForPendingWrites()
+{
+    if (this->async_writer == nullptr)
+    {
+        return HAL_OK;
+    }
+
+    return this->async_writer->waitUntilIdle(LOG_ASYNC_WRITE_TIMEOUT_MS);
+}
+
+/**
+ * @brief Reads back the last committed page and compares its CRC with the CRC of the RAM copy that
+ * was written. Pages committed again before they were checked are only checked in their latest state.
+ * @return The HAL status of the read.
+ */
+HAL_StatusTypeDef EEPROMLog::verifyCommittedPage()
+{
+    if (!this->verify_pending)
+    {
+        return HAL_OK;
+    }
+
+    HAL_StatusTypeDef status;
+    uint8_t buffer[LOG_RECORD_SIZE];
+
+    status = this->eeprom_array->readPage(this->verify_record_index, buffer, this->verify_length);
+
+    if (status != HAL_OK)
+    {
+        this->health_counters.read_error_count++;
+        return status;
+    }
+
+    this->verify_pending = false;
+    this->health_counters.verified_page_count++;
+
+    if (calculateCRC16(buffer, this->verify_length) != this->verify_crc)
+    {
+        this->health_counters.failed_page_count++;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reads the next stored record, cycling through the log and skipping the record currently
+ * being filled, and checks it against its CRC. Erased pages are skipped without being counted.
+ * @return The HAL status of the read, or HAL_ERROR if the EEPROM array has no pages.
+ */
+HAL_StatusTypeDef EEPROMLog::scrubNextRecord()
+{
+    if (this->record_count == 0)
+    {
+        return HAL_ERROR;
+    }
+
+    HAL_StatusTypeDef status;
+    uint8_t buffer[LOG_RECORD_SIZE];
+    uint16_t record_index = this->scrub_record_index;
+
+    this->scrub_record_index = (record_index + 1) % this->record_count;
+
+    if (this->scrub_record_index == 0)
+    {
+        this->health_counters.scrub_pass_count++;
+    }
+
+    if (record_index == this->record_index)
+    {
+        return HAL_OK;
+    }
+
+    status = this->eeprom_array->readPage(record_index, buffer, sizeof(buffer));
+
+    if (status != HAL_OK)
+    {
+        this->health_counters.read_error_count++;
+        return status;
+    }
+
+    if (buffer[0] == LOG_ERASED_BYTE && buffer[1] == LOG_ERASED_BYTE)
+    {
+        return HAL_OK;
+    }
+
+    this->health_counters.verified_page_count++;
+
+    if (!this->isRecordHeaderValid(buffer) || !this->isRecordIntact(buffer))
+    {
+        this->health_counters.failed_page_count++;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Writes the header, CRC, and all samples of the current record to its EEPROM page, or queues
+ * the page write if an asynchronous writer is set.
+ * @return The HAL status of the page write, or of queueing it (HAL_BUSY if the queue is full).
+ */
+HAL_StatusTypeDef EEPROMLog::commitRecord()
+{
+    HAL_StatusTypeDef status;
+
+    this->record_buffer[1] = this->sample_count;
+
+    uint16_t crc = this->calculateRecordCRC(this->record_buffer);
+    this->record_buffer[4] = crc >> 8;
+    this->record_buffer[5] = crc;
+
+    uint16_t length = this->getPayloadOffset(this->sensor_mask) + this->getPayloadLength(this->record_buffer);
+
+    if (this->async_writer != nullptr)
+    {
+        status = this->async_writer->submitPageWrite(
+            this->eeprom_array->getChipForPage(this->record_index),
+            this->eeprom_array->getChipAddressForPage(this->record_index),
+            this->record_buffer,
+            length);
+    }
+    else
+    {
+        status = this->eeprom_array->writePage(this->record_index, this->record_buffer, length);
+    }
+
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+
+    if (this->async_writer != nullptr)
+    {
+        this->record_write_count++;
+    }
+
+    this->committed_sample_count = this->sample_count;
+
+    if (this->verify_policy == LogVerifyPolicy::PerPage)
+    {
+        // Remember what was written, so that the page can be read back later in a background slot
+        this->verify_pending = true;
+        this->verify_record_index = this->record_index;
+        this->verify_length = length;
+        this->verify_crc = calculateCRC16(this->record_buffer, length);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Checks whether a page write targets the page of a record.
+ * @param record_index The index of the record (0 to getRecordCount() - 1).
+ * @param eeprom Pointer to the EEPROM that was written to.
+ * @param memory_address The address of the first byte of the page write.
+ * @return True if the write targets the page of the record, false otherwise.
+ */
+bool EEPROMLog::isRecordPage(uint16_t record_index, EEPROM *eeprom, uint16_t memory_address)
+{
+    return eeprom == this->eeprom_array->getChipForPage(record_index) &&
+           memory_address == this->eeprom_array->getChipAddressForPage(record_index);
+}
+
+/**
+ * @brief Handles the result of an asynchronous record write. A failed write of the open record marks
+ * its samples as not committed, so that the next append or flush queues the record again. A failed
+ * write of the closed record is queued again from its RAM copy, or written blocking if the queue
+ * does not take it, since the record will not be committed again and a missing record would end
+ * the consecutive sequence stamps that recoverHead relies on.
+ * @param eeprom Pointer to the EEPROM that was written to.
+ * @param memory_address The address of the first byte of the page write.
+ * @param status The final status of the page write.
+ */
+void EEPROMLog::handleWriteResult(EEPROM *eeprom, uint16_t memory_address, HAL_StatusTypeDef status)
+{
+    if (status != HAL_OK)
+    {
+        this->health_counters.write_error_count++;
+
+        // Reading back a page that was not written would count the same failure again
+        if (this->verify_pending && this->isRecordPage(this->verify_record_index, eeprom, memory_address))
+        {
+            this->verify_pending = false;
+        }
+    }
+
+    if (this->closed_record_write_count > 0 && this->isRecordPage(this->closed_record_index, eeprom, memory_address))
+    {
+        this->closed_record_write_count--;
+
+        if (status != HAL_OK)
+        {
+            if (this->async_writer->submitPageWrite(eeprom, memory_address, this->closed_record_buffer,
+                                                    this->closed_record_length) == HAL_OK)
+            {
+                this->closed_record_write_count++;
+            }
+            else if (this->eeprom_array->writePage(this->closed_record_index, this->closed_record_buffer,
+                                                   this->closed_record_length) != HAL_OK)
+            {
+                this->health_counters.write_error_count++;
+            }
+        }
+    }
+    else if (this->record_write_count > 0 && this->isRecordPage(this->record_index, eeprom, memory_address))
+    {
+        this->record_write_count--;
+
+        if (status != HAL_OK)
+        {
+            this->committed_sample_count = 0;
+        }
+    }
+
+    if (this->write_result_callback != nullptr)
+    {
+        this->write_result_callback(eeprom, memory_address, status, this->write_result_context);
+    }
+}
+
+/**
+ * @brief Forwards the completion callback of the asynchronous writer to the log. Called from
+ * EEPROMAsync::service.
+ * @param eeprom Pointer to the EEPROM that was written to.
+ * @param memory_address The address of the first byte of the page write.
+ * @param status The final status of the page write.
+ * @param context Pointer to the EEPROMLog.
+ */
+void EEPROMLog::handleAsyncWriteResult(EEPROM *eeprom, uint16_t memory_address, HAL_StatusTypeDef status, void *context)
+{
+    static_cast<EEPROMLog *>(context)->handleWriteResult(eeprom, memory_address, status);
+}
+
+/**
+ * @brief Keeps a RAM copy of the current record before it is closed while its page writes are still
+ * queued, so that a failed write can be queued again. Only one closed record is kept, so the writes
+ * of the previous one have to complete first.
+ * @return HAL_OK if the record can be closed, or HAL_TIMEOUT if the writes of the previous closed
+ * record do not complete in time.
+ */
+HAL_StatusTypeDef EEPROMLog::retainClosedRecord()
+{
+    if (this->record_write_count > 0 && this->closed_record_write_count > 0)
+    {
+        HAL_StatusTypeDef status = this->waitForPendingWrites();
+
+        if (status != HAL_OK)
+        {
+            return status;
+        }
+    }
+
+    if (this->record_write_count == 0)
+    {
+        return HAL_OK;
+    }
+
+    memcpy(this->closed_record_buffer, this->record_buffer, LOG_RECORD_SIZE);
+    this->closed_record_index = this->record_index;
+    this->closed_record_length = this->getPayloadOffset(this->sensor_mask) + this->getPayloadLength(this->record_buffer);
+    this->closed_record_write_count = this->record_write_count;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Starts a new, empty record in RAM.
+ * @param record_index The index of the record (0 to getRecordCount() - 1).
+ * @param sequence The sequence stamp of the record.
+ */
+void EEPROMLog::startRecord(uint16_t record_index, uint16_t sequence)
+{
+    this->record_index = record_index;
+    this->sequence = sequence;
+    this->sample_count = 0;
+    this->committed_sample_count = 0;
+    this->record_write_count = 0;
+    this->delta_state = {};
+
+    this->record_buffer[0] = (this->sensor_mask != 0 ? LOG_RECORD_TAGGED_MARKER : LOG_RECORD_MARKER) | this->sample_format;
+    this->record_buffer[1] = 0;
+    this->record_buffer[2] = sequence >> 8;
+    this->record_buffer[3] = sequence;
+    this->record_buffer[LOG_RECORD_HEADER_SIZE] = this->sensor_mask;
+
+    // Packed samples share bytes, so start from a clean payload
+    uint8_t payload_offset = this->getPayloadOffset(this->sensor_mask);
+    memset(&this->record_buffer[payload_offset], 0, LOG_RECORD_SIZE - payload_offset);
+}
@@ -10,16 +10,40 @@
 
 // Masks for TMP100 configuration bits
 constexpr uint8_t SD_BIT_MASK = 0x01;
+constexpr uint8_t TM_BIT_MASK = 0x02;
+constexpr uint8_t POL_BIT_MASK = 0x04;
+constexpr uint8_t F1F0_BIT_MASK = 0x18;
 constexpr uint8_t OS_BIT_MASK = 0x80;
 constexpr uint8_t R1R0_BIT_MASK = 0x60;
 
 // TMP100 register addresses
 constexpr uint8_t TEMPERATURE_REG = 0x00;
 constexpr uint8_t CONFIGURATION_REG = 0x01;
+constexpr uint8_t TLOW_REG = 0x02;
+constexpr uint8_t THIGH_REG = 0x03;
+
+// Pointer Register value while the selected register is not known (e.g. after a failed write)
+constexpr uint8_t POINTER_UNKNOWN = 0xFF;
+
+// Limit register values that force the comparator active (every temperature is >= -128C) or
+// inactive (no temperature is >= +127.9375C) after the next conversion
+constexpr uint16_t LIMIT_ALERT_ALWAYS = 0x8000;
+constexpr uint16_t LIMIT_ALERT_NEVER = 0x7FF0;
+
+// Default interval between OS/ALERT bit polls in the adaptive wait mode
+constexpr uint32_t DEFAULT_POLL_INTERVAL_MS = 5;
 
 // Bit shift for extracting resolution from the configuration byte
 constexpr int RESOLUTION_BIT_SHIFT = 5;
 
+// The Temperature Register holds the temperature in Q8.8 format (1/256C per LSB), left-justified to
+// the resolution; these masks clear the bits below the resolution (9 to 12 bits)
+constexpr uint16_t Q8_8_RESOLUTION_MASK[4] = {
+	static_cast<uint16_t>(0xFFFF << 7),
+	static_cast<uint16_t>(0xFFFF << 6),
+	static_cast<uint16_t>(0xFFFF << 5),
+	static_cast<uint16_t>(0xFFFF << 4)};
+
 using utility::getI2CReadAddress, utility::getI2CWriteAddress;
 
 /**
@@ -29,7 +53,8 @@ using utility::getI2CReadAddress, utility::getI2CWriteAddress;
  */
 
 /**
- * @brief Constructs a TMP100 object and initializes its resolution bits.
+ * @brief Constructs a TMP100 object, reads the configuration into the shadow copy, and initializes
+ * its resolution bits and conversion state. The wait mode defaults to TMP100WaitMode::FixedDelay.
  * @param i2c_handle Pointer to the I2C handle used for communication.
  * @param i2c_address The 7-bit I2C address of the TMP100 device.
  */
@@ -38,11 +63,34 @@ TMP100::TMP100(I2C_HandleTypeDef *i2c_handle, uint8_t i2c_address) : i2c_handle(
 	HAL_StatusTypeDef status;
 	uint8_t config_byte;
 
+	this->config_shadow = 0;
+	this->config_shadow_valid = false;
+	this->pointer_reg = POINTER_UNKNOWN;
+	this->transaction_count = 0;
+	this->conversion_pending = false;
+	this->conversion_start_ms = 0;
+	this->conversion_time_ms = 0;
+	this->wait_mode = TMP100WaitMode::FixedDelay;
+	this->poll_interval_ms = DEFAULT_POLL_INTERVAL_MS;
+	this->next_poll_ms = 0;
+	this->detection_armed = false;
+	this->alert_state_known = false;
+	this->alert_state = 0;
+	this->conversion_stats = {};
+	this->conversion_stats.min_ms = UINT32_MAX;
+
+	// Typical conversions take about half of the fixed conversion time
+	for (size_t i = 0; i < 4; i++)
+	{
+		this->conversion_estimate_ms[i] = this->resolution_conversion_time[i] / 2;
+	}
+
 	status = this->readConfigurationReg(&config_byte);
 
 	if (status == HAL_OK)
 	{
-		this->updateResolutionBits(config_byte);
+		this->alert_state = config_byte & OS_BIT_MASK;
+		this->alert_state_known = true;
 	}
 	else
 	{
@@ -51,7 +99,17 @@ TMP100::TMP100(I2C_HandleTypeDef *i2c_handle, uint8_t i2c_address) : i2c_handle(
 }
 
 /**
- * @brief Writes a configuration byte to the Configuration Register of the TMP100.
+ * @brief Retrieves the I2C address of the TMP100.
+ * @return The 7-bit I2C address of the TMP100 device.
+ */
+uint8_t TMP100::getI2CAddress()
+{
+	return this->i2c_address;
+}
+
+/**
+ * @brief Writes a configuration byte to the Configuration Register of the TMP100 and keeps a shadow
+ * copy of it, so that the register does not have to be read back before later writes.
  * @param config_byte The configuration byte to write to the Configuration Register.
  * @return The HAL status of the I2C transmission.
  */
@@ -62,59 +120,216 @@ HAL_StatusTypeDef TMP100::writeConfigurationReg(uint8_t config_byte)
 	buffer[0] = CONFIGURATION_REG;
 	buffer[1] = config_byte;
 
-	status = HAL_I2C_Master_Transmit(
-		this->i2c_handle,
-		getI2CWriteAddress(this->i2c_address),
-		buffer,
-		sizeof(buffer),
-		HAL_MAX_DELAY);
+	status = this->transmit(buffer, sizeof(buffer));
 
 	if (status != HAL_OK)
 	{
+		this->config_shadow_valid = false;
 		return status;
 	}
 
+	// The POL bit inverts the OS/ALERT bit as read back
+	if (!this->config_shadow_valid || ((config_byte ^ this->config_shadow) & POL_BIT_MASK))
+	{
+		this->alert_state_known = false;
+	}
+
+	this->config_shadow = config_byte & ~OS_BIT_MASK;
+	this->config_shadow_valid = true;
 	this->updateResolutionBits(config_byte);
 
 	return HAL_OK;
 }
 
 /**
- * @brief Triggers a one-shot temperature conversion on the TMP100.
+ * @brief Triggers a one-shot temperature conversion on the TMP100 and waits for it to complete.
  * @return The HAL status of the I2C operations. Returns HAL_ERROR if the sensor is
  * not in shutdown mode or if an I2C operation fails.
  */
 HAL_StatusTypeDef TMP100::triggerOneShotTemperatureConversion()
 {
 	HAL_StatusTypeDef status;
-	uint8_t config_byte;
 
-	status = this->readConfigurationReg(&config_byte);
+	status = this->startConversion();
 
 	if (status != HAL_OK)
 	{
 		return status;
 	}
 
-	if (!(config_byte & SD_BIT_MASK))
+	while (!this->isConversionDone())
+	{
+	}
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Starts a one-shot temperature conversion on the TMP100 and returns without waiting for
+ * it. The result can be read once isConversionDone returns true. The conversion is started by a
+ * single write of the shadow configuration with the OS bit set; the Configuration Register is only
+ * read if the shadow copy is not valid.
+ * @return The HAL status of the I2C operations. Returns HAL_ERROR if the sensor is
+ * not in shutdown mode or if an I2C operation fails.
+ */
+HAL_StatusTypeDef TMP100::startConversion()
+{
+	HAL_StatusTypeDef status;
+	uint8_t config_byte;
+
+	if (!this->config_shadow_valid)
+	{
+		status = this->readConfigurationReg(&config_byte);
+
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+
+		this->alert_state = config_byte & OS_BIT_MASK;
+		this->alert_state_known = true;
+	}
+
+	if (!(this->config_shadow & SD_BIT_MASK))
 	{
 		return HAL_ERROR;
 	}
 
-	config_byte = config_byte | OS_BIT_MASK;
-	status = this->writeConfigurationReg(config_byte);
+	this->detection_armed = false;
+
+	if (this->wait_mode == TMP100WaitMode::Adaptive)
+	{
+		status = this->armCompletionDetection();
+
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+	}
+
+	status = this->writeConfigurationReg(this->config_shadow | OS_BIT_MASK);
 
 	if (status != HAL_OK)
 	{
 		return status;
 	}
 
-	int conversion_time = this->resolution_conversion_time[this->resolution_bits];
-	HAL_Delay(conversion_time);
+	// Start polling one interval before the learned conversion time, so the estimate can also decrease
+	uint32_t estimate_ms = this->conversion_estimate_ms[this->resolution_bits];
+	this->next_poll_ms = (estimate_ms > this->poll_interval_ms) ? estimate_ms - this->poll_interval_ms : 0;
+
+	this->conversion_start_ms = HAL_GetTick();
+	this->conversion_time_ms = this->resolution_conversion_time[this->resolution_bits];
+	this->conversion_pending = true;
 
 	return HAL_OK;
 }
 
+/**
+ * @brief Checks whether the conversion started by startConversion has completed. In the fixed delay
+ * mode the conversion is considered done once the conversion time of the current resolution has
+ * elapsed. In the adaptive mode the OS/ALERT bit is polled for the comparator toggle armed by
+ * startConversion, with the conversion time as the upper bound.
+ * @return True if the Temperature Register holds the result of the last conversion.
+ */
+bool TMP100::isConversionDone()
+{
+	if (!this->conversion_pending)
+	{
+		return true;
+	}
+
+	uint32_t elapsed_ms = HAL_GetTick() - this->conversion_start_ms;
+
+	// The start tick may have been about to advance, so wait one tick longer, as HAL_Delay does
+	if (elapsed_ms > this->conversion_time_ms)
+	{
+		// A missed toggle leaves the comparator state unknown
+		if (this->detection_armed)
+		{
+			this->alert_state_known = false;
+		}
+
+		this->recordConversionTime(this->conversion_time_ms, this->detection_armed);
+		this->conversion_pending = false;
+		return true;
+	}
+
+	if (!this->detection_armed || elapsed_ms < this->next_poll_ms)
+	{
+		return false;
+	}
+
+	if (!this->pollCompletion(elapsed_ms))
+	{
+		return false;
+	}
+
+	this->recordConversionTime(elapsed_ms, false);
+	this->conversion_pending = false;
+
+	return true;
+}
+
+/**
+ * @brief Retrieves the tick at which the result of the last started conversion is ready.
+ * @return The HAL tick (in milliseconds) of the conversion deadline.
+ */
+uint32_t TMP100::getConversionDeadline()
+{
+	return this->conversion_start_ms + this->conversion_time_ms + 1;
+}
+
+/**
+ * @brief Selects how completed conversions are detected and resets the conversion statistics, so
+ * that the latencies of both modes can be compared.
+ * @param mode The wait mode, either TMP100WaitMode::FixedDelay or TMP100WaitMode::Adaptive.
+ * @param poll_interval_ms The interval between OS/ALERT bit polls in the adaptive mode (at least 1 ms).
+ */
+void TMP100::setWaitMode(TMP100WaitMode mode, uint32_t poll_interval_ms)
+{
+	this->wait_mode = mode;
+	this->poll_interval_ms = (poll_interval_ms > 0) ? poll_interval_ms : 1;
+	this->conversion_stats = {};
+	this->conversion_stats.min_ms = UINT32_MAX;
+}
+
+/**
+ * @brief Retrieves the current wait mode.
+ * @return The wait mode selected by setWaitMode.
+ */
+TMP100WaitMode TMP100::getWaitMode()
+{
+	return this->wait_mode;
+}
+
+/**
+ * @brief Retrieves the conversion time learned in the adaptive mode for the current resolution.
+ * @return The estimated conversion time in milliseconds.
+ */
+uint32_t TMP100::getConversionEstimate()
+{
+	return this->conversion_estimate_ms[this->resolution_bits];
+}
+
+/**
+ * @brief Retrieves the measured conversion latencies.
+ * @return Reference to the conversion statistics.
+ */
+const TMP100ConversionStats &TMP100::getConversionStats()
+{
+	return this->conversion_stats;
+}
+
+/**
+ * @brief Retrieves the number of I2C transactions (START to STOP) sent to the TMP100 since construction.
+ * @return The number of transactions, including failed ones.
+ */
+uint32_t TMP100::getTransactionCount()
+{
+	return this->transaction_count;
+}
+
 /**
  * @brief Reads the raw temperature data from the Temperature Register of the TMP100.
  * @param temperature Pointer to a 16-bit variable where the raw temperature data will be stored.
@@ -130,19 +345,7 @@ HAL_StatusTypeDef TMP100::readTemperatureReg(uint16_t *temperature)
 	HAL_StatusTypeDef status;
 	uint8_t buffer[2] = {0};
 
-	status = this->writePointerReg(TEMPERATURE_REG);
-
-	if (status != HAL_OK)
-	{
-		return status;
-	}
-
-	status = HAL_I2C_Master_Receive(
-		this->i2c_handle,
-		getI2CReadAddress(this->i2c_address),
-		buffer,
-		sizeof(buffer),
-		HAL_MAX_DELAY);
+	status = this->readRegister(TEMPERATURE_REG, buffer, sizeof(buffer));
 
 	if (status != HAL_OK)
 	{
@@ -166,6 +369,132 @@ float TMP100::convertRawTemperatureDataToCelsius(uint16_t raw_temperature_data)
     return signed_raw_temperature_data * this->resolution[this->resolution_bits];
 }
 
+/**
+ * @brief Converts raw temperature data from the TMP100 to Q8.8 fixed point without floating-point arithmetic.
+ * @param raw_temperature_data The 16-bit raw temperature data read from the TMP100.
+ * @return The temperature in units of 1/256C.
+ */
+int16_t TMP100::convertRawTemperatureDataToQ8_8(uint16_t raw_temperature_data)
+{
+	return static_cast<int16_t>(raw_temperature_data & Q8_8_RESOLUTION_MASK[this->resolution_bits]);
+}
+
+/**
+ * @brief Converts raw temperature data from the TMP100 to hundredths of a degree Celsius without
+ * floating-point arithmetic, rounded to the nearest hundredth with ties to even like printf
+ * (e.g. 23.4375C to 2344 and 23.125C to 2312).
+ * @param raw_temperature_data The 16-bit raw temperature data read from the TMP100.
+ * @return The temperature in units of 0.01C.
+ */
+int16_t TMP100::convertRawTemperatureDataToCentiCelsius(uint16_t raw_temperature_data)
+{
+	return utility::convertQ8_8ToCentiCelsius(this->convertRawTemperatureDataToQ8_8(raw_temperature_data));
+}
+
+/**
+ * @brief Retrieves the resolution bits (R1 and R0) of the current configuration.
+ * @return The resolution bits, from 0b00 (9-bit, 0.5C) to 0b11 (12-bit, 0.0625C).
+ */
+uint8_t TMP100::getResolutionBits()
+{
+	return this->resolution_bits;
+}
+
+/**
+ * @brief Changes the resolution of the following conversions with a single write of the shadow
+ * configuration. The resolution bits used to convert and log the raw temperature data follow the
+ * write, so call it only after the result of the last conversion has been read and converted.
+ * @param resolution_bits The resolution bits, from 0b00 (9-bit, 0.5C) to 0b11 (12-bit, 0.0625C).
+ * @return The HAL status of the I2C operations. Returns HAL_BUSY while a conversion is pending, or
+ * HAL_ERROR if the resolution bits are invalid.
+ */
+HAL_StatusTypeDef TMP100::setResolutionBits(uint8_t resolution_bits)
+{
+	HAL_StatusTypeDef status;
+	uint8_t config_byte;
+
+	if (resolution_bits > 0b11)
+	{
+		return HAL_ERROR;
+	}
+
+	if (this->conversion_pending)
+	{
+		return HAL_BUSY;
+	}
+
+	if (!this->config_shadow_valid)
+	{
+		status = this->readConfigurationReg(&config_byte);
+
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+	}
+
+	if (resolution_bits == this->resolution_bits)
+	{
+		return HAL_OK;
+	}
+
+	config_byte = (this->config_shadow & ~R1R0_BIT_MASK) | (resolution_bits << RESOLUTION_BIT_SHIFT);
+
+	return this->writeConfigurationReg(config_byte);
+}
+
+/**
+ * @brief Switches between continuous conversions (SD bit LOW) and the shutdown mode (SD bit HIGH)
+ * with a single write of the shadow configuration. In continuous mode the sensor converts
+ * back-to-back at the conversion time of the current resolution and the Temperature Register
+ * always holds the last result; one-shot conversions are only possible in the shutdown mode.
+ * Leaving the continuous mode completes the conversion in progress before the sensor shuts down.
+ * @param enabled True to start continuous conversions, false to return to the shutdown mode.
+ * @return The HAL status of the I2C operations. Returns HAL_BUSY while a one-shot conversion is pending.
+ */
+HAL_StatusTypeDef TMP100::setContinuousConversion(bool enabled)
+{
+	HAL_StatusTypeDef status;
+	uint8_t config_byte;
+
+	if (this->conversion_pending)
+	{
+		return HAL_BUSY;
+	}
+
+	if (!this->config_shadow_valid)
+	{
+		status = this->readConfigurationReg(&config_byte);
+
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+	}
+
+	config_byte = enabled ? (this->config_shadow & ~SD_BIT_MASK) : (this->config_shadow | SD_BIT_MASK);
+
+	if (config_byte == this->config_shadow)
+	{
+		return HAL_OK;
+	}
+
+	// The comparator follows every continuous conversion, so its state is read again before the next one-shot
+	this->alert_state_known = false;
+
+	return this->writeConfigurationReg(config_byte);
+}
+
+/**
+ * @brief Retrieves the maximum conversion time of a resolution.
+ * @param resolution_bits The resolution bits, from 0b00 (9-bit) to 0b11 (12-bit).
+ * @return The conversion time in milliseconds.
+ */
+uint32_t TMP100::getConversionTime(uint8_t resolution_bits)
+{
+	return resolution_conversion_time[resolution_bits & 0b11];
+}
+
 /**
  * ------------------------------------------------------------------------------------------------
  * @section Private_Methods Private Methods
@@ -182,26 +511,102 @@ void TMP100::updateResolutionBits(uint8_t config_byte)
 }
 
 /**
- * @brief Writes to the Pointer Register of the TMP100.
- * @param reg_address The address of the register to select (e.g. Temperature, Configuration, T_LOW, or T_HIGH registers).
+ * @brief Sends a write transaction to the TMP100. The first byte of every write selects the register
+ * in the Pointer Register, which is tracked so that reads of the selected register need no pointer write.
+ * @param buffer Pointer to the data to send, starting with the register address.
+ * @param length The number of bytes to send.
  * @return The HAL status of the I2C transmission.
  */
-HAL_StatusTypeDef TMP100::writePointerReg(uint8_t reg_address)
+HAL_StatusTypeDef TMP100::transmit(uint8_t *buffer, uint16_t length)
 {
 	HAL_StatusTypeDef status;
 
 	status = HAL_I2C_Master_Transmit(
 		this->i2c_handle,
 		getI2CWriteAddress(this->i2c_address),
-		&reg_address,
-		sizeof(reg_address),
+		buffer,
+		length,
 		HAL_MAX_DELAY);
 
+	// HAL_BUSY means the transaction was not started (e.g. during a background EEPROM transfer)
+	if (status == HAL_BUSY)
+	{
+		return status;
+	}
+
+	this->transaction_count++;
+	this->pointer_reg = (status == HAL_OK) ? buffer[0] : POINTER_UNKNOWN;
+
 	return status;
 }
 
 /**
- * @brief Reads the configuration byte from the Configuration Register of the TMP100.
+ * @brief Sends a read transaction to the TMP100, which returns the register selected by the Pointer Register.
+ * @param buffer Pointer to the buffer where the received data will be stored.
+ * @param length The number of bytes to receive.
+ * @return The HAL status of the I2C reception.
+ */
+HAL_StatusTypeDef TMP100::receive(uint8_t *buffer, uint16_t length)
+{
+	HAL_StatusTypeDef status;
+
+	status = HAL_I2C_Master_Receive(
+		this->i2c_handle,
+		getI2CReadAddress(this->i2c_address),
+		buffer,
+		length,
+		HAL_MAX_DELAY);
+
+	if (status != HAL_BUSY)
+	{
+		this->transaction_count++;
+	}
+
+	return status;
+}
+
+/**
+ * @brief Reads a register of the TMP100. If the Pointer Register already selects the register, the
+ * TMP100 is read directly, since it keeps the pointer between reads. Otherwise the pointer write and
+ * the read are joined by a repeated START into a single transaction.
+ * @param reg_address The address of the register to read (e.g. Temperature, Configuration, T_LOW, or T_HIGH registers).
+ * @param buffer Pointer to the buffer where the register contents will be stored.
+ * @param length The number of bytes to read.
+ * @return The HAL status of the I2C operation.
+ */
+HAL_StatusTypeDef TMP100::readRegister(uint8_t reg_address, uint8_t *buffer, uint16_t length)
+{
+	if (this->pointer_reg == reg_address)
+	{
+		return this->receive(buffer, length);
+	}
+
+	HAL_StatusTypeDef status;
+
+	status = HAL_I2C_Mem_Read(
+		this->i2c_handle,
+		getI2CWriteAddress(this->i2c_address),
+		reg_address,
+		I2C_MEMADD_SIZE_8BIT,
+		buffer,
+		length,
+		HAL_MAX_DELAY);
+
+	// HAL_BUSY means the transaction was not started (e.g. during a background EEPROM transfer)
+	if (status == HAL_BUSY)
+	{
+		return status;
+	}
+
+	this->transaction_count++;
+	this->pointer_reg = (status == HAL_OK) ? reg_address : POINTER_UNKNOWN;
+
+	return status;
+}
+
+/**
+ * @brief Reads the configuration byte from the Configuration Register of the TMP100 and refreshes
+ * the shadow copy. The OS/ALERT bit of the returned byte holds the comparator state.
  * @param config_byte Pointer to an 8-bit variable where the configuration byte will be stored.
  * @return THe HAL status of the I2C operation.
  */
@@ -215,30 +620,158 @@ HAL_StatusTypeDef TMP100::readConfigurationReg(uint8_t *config_byte)
 	HAL_StatusTypeDef status;
 	uint8_t buffer[1] = {0};
 
-	status = this->writePointerReg(CONFIGURATION_REG);
+	status = this->readRegister(CONFIGURATION_REG, buffer, sizeof(buffer));
 
 	if (status != HAL_OK)
 	{
 		return status;
 	}
 
-	status = HAL_I2C_Master_Receive(
-		this->i2c_handle,
-		getI2CReadAddress(this->i2c_address),
-		buffer,
-		sizeof(buffer),
-		HAL_MAX_DELAY);
+	*config_byte = buffer[0];
+	this->config_shadow = buffer[0] & ~OS_BIT_MASK;
+	this->config_shadow_valid = true;
+	this->updateResolutionBits(buffer[0]);
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Writes the same value to the T_LOW and T_HIGH Registers of the TMP100.
+ * @param limit The 16-bit limit in the format of the Temperature Register.
+ * @return The HAL status of the I2C transmissions.
+ */
+HAL_StatusTypeDef TMP100::writeLimitRegs(uint16_t limit)
+{
+	HAL_StatusTypeDef status;
+	uint8_t buffer[3];
+	buffer[1] = limit >> 8;
+	buffer[2] = limit;
+
+	buffer[0] = THIGH_REG;
+	status = this->transmit(buffer, sizeof(buffer));
 
 	if (status != HAL_OK)
 	{
 		return status;
 	}
 
-	*config_byte = buffer[0];
+	buffer[0] = TLOW_REG;
+	status = this->transmit(buffer, sizeof(buffer));
+
+	return status;
+}
+
+/**
+ * @brief Prepares the comparator so that the OS/ALERT bit toggles when the next conversion completes.
+ * The OS/ALERT bit of the TMP100 reads back the comparator state rather than the conversion state,
+ * so both limits are set to a value that forces the comparator into the opposite of its current
+ * state. This requires comparator mode and a fault queue of one; otherwise the conversion time
+ * remains the only completion criterion. The comparator state is tracked across conversions and
+ * only read from the sensor if it is not known.
+ * @return The HAL status of the I2C operations.
+ */
+HAL_StatusTypeDef TMP100::armCompletionDetection()
+{
+	if (this->config_shadow & (TM_BIT_MASK | F1F0_BIT_MASK))
+	{
+		return HAL_OK;
+	}
+
+	HAL_StatusTypeDef status;
+
+	if (!this->alert_state_known)
+	{
+		uint8_t config_byte;
+		status = this->readConfigurationReg(&config_byte);
+
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+
+		this->alert_state = config_byte & OS_BIT_MASK;
+		this->alert_state_known = true;
+	}
+
+	bool alert_active = (this->alert_state != 0) == ((this->config_shadow & POL_BIT_MASK) != 0);
+
+	status = this->writeLimitRegs(alert_active ? LIMIT_ALERT_NEVER : LIMIT_ALERT_ALWAYS);
+
+	if (status != HAL_OK)
+	{
+		return status;
+	}
+
+	this->detection_armed = true;
 
 	return HAL_OK;
 }
 
+/**
+ * @brief Polls the OS/ALERT bit for the comparator toggle that marks a completed conversion.
+ * @param elapsed_ms The time since the start of the conversion in milliseconds.
+ * @return True if the conversion has completed. False if it is still in progress or if the I2C bus
+ * is busy (e.g. with a background EEPROM transfer), in which case the poll is retried on the next call.
+ */
+bool TMP100::pollCompletion(uint32_t elapsed_ms)
+{
+	uint8_t config_byte;
+
+	if (this->readConfigurationReg(&config_byte) != HAL_OK)
+	{
+		return false;
+	}
+
+	this->conversion_stats.poll_count++;
+	this->next_poll_ms = elapsed_ms + this->poll_interval_ms;
+
+	if ((config_byte & OS_BIT_MASK) == this->alert_state)
+	{
+		return false;
+	}
+
+	this->alert_state = config_byte & OS_BIT_MASK;
+
+	return true;
+}
+
+/**
+ * @brief Records a conversion latency and updates the learned conversion time of the current resolution.
+ * @param conversion_ms The time from the start of the conversion to its detected completion.
+ * @param timed_out True if the adaptive mode did not detect the completion before the conversion time.
+ */
+void TMP100::recordConversionTime(uint32_t conversion_ms, bool timed_out)
+{
+	TMP100ConversionStats &stats = this->conversion_stats;
+
+	stats.count++;
+	stats.last_ms = conversion_ms;
+	stats.total_ms += conversion_ms;
+
+	if (conversion_ms < stats.min_ms)
+	{
+		stats.min_ms = conversion_ms;
+	}
+
+	if (conversion_ms > stats.max_ms)
+	{
+		stats.max_ms = conversion_ms;
+	}
+
+	if (timed_out)
+	{
+		stats.timeout_count++;
+		return;
+	}
+
+	if (this->detection_armed)
+	{
+		// Moving average with a weight of 1/4 for the new measurement
+		uint32_t &estimate_ms = this->conversion_estimate_ms[this->resolution_bits];
+		estimate_ms = (3 * estimate_ms + conversion_ms) / 4;
+	}
+}
+
 /**
  * ------------------------------------------------------------------------------------------------
  * @section Static_Constants Static Constants
@@ -0,0 +1,208 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TMP100Array.cpp
+ * @brief Implementation file for the TMP100Array class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "TMP100Array.h"
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs a TMP100Array that runs the one-shot conversions of several TMP100 sensors in
+ * parallel. The sensors are ordered by address; sensor n of the sensor mask is the TMP100 at address
+ * 0x48 + n.
+ * @param sensors Pointer to an array of TMP100 sensors, in any order.
+ * @param sensor_count The number of sensors (1 to TMP100_ARRAY_MAX_SENSORS). Sensors outside the
+ * TMP100 address range and further sensors at the same address are ignored.
+ */
+TMP100Array::TMP100Array(TMP100 *const *sensors, uint8_t sensor_count)
+{
+	this->sensor_mask = 0;
+	this->pending_mask = 0;
+
+	for (uint8_t i = 0; i < TMP100_ARRAY_MAX_SENSORS; i++)
+	{
+		this->sensors[i] = nullptr;
+	}
+
+	for (uint8_t i = 0; i < sensor_count; i++)
+	{
+		uint8_t sensor_tag = sensors[i]->getI2CAddress() - TMP100_BASE_ADDRESS;
+
+		if (sensor_tag >= TMP100_ARRAY_MAX_SENSORS || this->sensors[sensor_tag] != nullptr)
+		{
+			continue;
+		}
+
+		this->sensors[sensor_tag] = sensors[i];
+		this->sensor_mask |= 1 << sensor_tag;
+	}
+}
+
+/**
+ * @brief Retrieves the number of TMP100 sensors in the array.
+ * @return The sensor count.
+ */
+uint8_t TMP100Array::getSensorCount()
+{
+	return __builtin_popcount(this->sensor_mask);
+}
+
+/**
+ * @brief Retrieves the mask of the TMP100 sensors in the array.
+ * @return The sensor mask, bit n set for the TMP100 at address 0x48 + n.
+ */
+uint8_t TMP100Array::getSensorMask()
+{
+	return this->sensor_mask;
+}
+
+/**
+ * @brief Retrieves a TMP100 sensor of the array.
+ * @param sensor_index The index of the sensor in ascending address order (0 to sensor count - 1).
+ * @return Pointer to the TMP100, or nullptr if the index is out of range.
+ */
+TMP100 *TMP100Array::getSensor(uint8_t sensor_index)
+{
+	for (uint8_t i = 0; i < TMP100_ARRAY_MAX_SENSORS; i++)
+	{
+		if (this->sensors[i] != nullptr && sensor_index-- == 0)
+		{
+			return this->sensors[i];
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * @brief Changes the resolution of the following conversions on every sensor, so that all sensors
+ * of a scan share one resolution.
+ * @param resolution_bits The resolution bits, from 0b00 (9-bit, 0.5C) to 0b11 (12-bit, 0.0625C).
+ * @return The HAL status of the first failed change, or HAL_OK if all sensors were changed.
+ */
+HAL_StatusTypeDef TMP100Array::setResolutionBits(uint8_t resolution_bits)
+{
+	HAL_StatusTypeDef result = HAL_OK;
+
+	for (uint8_t i = 0; i < TMP100_ARRAY_MAX_SENSORS; i++)
+	{
+		if (this->sensors[i] == nullptr)
+		{
+			continue;
+		}
+
+		HAL_StatusTypeDef status = this->sensors[i]->setResolutionBits(resolution_bits);
+
+		if (status != HAL_OK && result == HAL_OK)
+		{
+			result = status;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief Starts a one-shot conversion on every sensor, back-to-back, so that all conversions run
+ * in parallel and the whole array takes the time of its slowest conversion instead of the sum of
+ * all conversion times. A sensor that fails to start is skipped and the others are still started.
+ * @return The HAL status of the first failed start, or HAL_OK if all conversions were started.
+ */
+HAL_StatusTypeDef TMP100Array::startConversions()
+{
+	HAL_StatusTypeDef result = HAL_OK;
+
+	this->pending_mask = 0;
+
+	for (uint8_t i = 0; i < TMP100_ARRAY_MAX_SENSORS; i++)
+	{
+		if (this->sensors[i] == nullptr)
+		{
+			continue;
+		}
+
+		HAL_StatusTypeDef status = this->sensors[i]->startConversion();
+
+		if (status == HAL_OK)
+		{
+			this->pending_mask |= 1 << i;
+		}
+		else if (result == HAL_OK)
+		{
+			result = status;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * @brief Checks whether the conversions started by startConversions have completed on all
+ * sensors. Sensors whose conversion is done are not checked again.
+ * @return True if the Temperature Registers of all started sensors hold their results.
+ */
+bool TMP100Array::areConversionsDone()
+{
+	for (uint8_t i = 0; i < TMP100_ARRAY_MAX_SENSORS; i++)
+	{
+		if ((this->pending_mask & (1 << i)) && !this->sensors[i]->isConversionDone())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Reads the Temperature Registers of all sensors with a started conversion, back-to-back.
+ * Call once areConversionsDone returns true. A sensor that fails to respond is skipped and the
+ * others are still read.
+ * @param raw_temperatures Pointer to an array of TMP100_ARRAY_MAX_SENSORS values where the raw
+ * temperature data of the sensors that were read will be stored, in ascending address order.
+ * @param sensor_mask Pointer to a variable where the mask of the sensors that were read will be stored.
+ * @return The HAL status of the first failed read, or HAL_OK if all sensors were read.
+ */
+HAL_StatusTypeDef TMP100Array::readTemperatures(uint16_t *raw_temperatures, uint8_t *sensor_mask)
+{
+	if (raw_temperatures == nullptr || sensor_mask == nullptr)
+	{
+		return HAL_ERROR;
+	}
+
+	HAL_StatusTypeDef result = HAL_OK;
+	uint8_t read_count = 0;
+
+	*sensor_mask = 0;
+
+	for (uint8_t i = 0; i < TMP100_ARRAY_MAX_SENSORS; i++)
+	{
+		if (!(this->pending_mask & (1 << i)))
+		{
+			continue;
+		}
+
+		HAL_StatusTypeDef status = this->sensors[i]->readTemperatureReg(&raw_temperatures[read_count]);
+
+		if (status == HAL_OK)
+		{
+			*sensor_mask |= 1 << i;
+			read_count++;
+		}
+		else if (result == HAL_OK)
+		{
+			result = status;
+		}
+	}
+
+	this->pending_mask = 0;
+
+	return result;
+}
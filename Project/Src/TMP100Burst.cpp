@@ -0,0 +1,256 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TMP100Burst.cpp
+ * @brief Implementation file for the TMP100Burst class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+
+#include "TMP100Burst.h"
+#include "project_utility.h"
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs a TMP100Burst that samples a TMP100 in continuous-conversion mode at up to the
+ * conversion rate and buffers the readings in RAM.
+ * @param temperature_sensor Pointer to the TMP100 to sample.
+ */
+TMP100Burst::TMP100Burst(TMP100 *temperature_sensor) : temperature_sensor(temperature_sensor)
+{
+	this->sample_count = 0;
+	this->stats = {};
+}
+
+/**
+ * @brief Captures a burst of readings: switches the TMP100 to continuous conversions at the given
+ * resolution, reads the Temperature Register once per period, and returns it to the shutdown mode
+ * and its previous resolution afterwards. The reads are scheduled from the start of the burst, so
+ * a late read does not shift the following ones, and a read that misses its slot entirely is
+ * counted as an overrun and skipped. Blocks for the length of the window and requires the I2C bus
+ * and the cycle counter, so call it while no background EEPROM transfer is pending.
+ * @param resolution_bits The resolution bits, from 0b00 (9-bit, 40 ms) to 0b11 (12-bit, 320 ms).
+ * @param window_ms The length of the burst in milliseconds. The burst also ends once
+ * TMP100_BURST_MAX_SAMPLES readings are buffered.
+ * @param period_ms The time between reads in milliseconds, at least the conversion time of the
+ * resolution, or 0 for the conversion time. Shorter periods would read the same conversion twice.
+ * @return The HAL status of the I2C operations. Returns HAL_ERROR if an argument is invalid.
+ */
+HAL_StatusTypeDef TMP100Burst::capture(uint8_t resolution_bits, uint32_t window_ms, uint32_t period_ms)
+{
+	uint32_t conversion_time_ms = TMP100::getConversionTime(resolution_bits);
+
+	if (period_ms == 0)
+	{
+		period_ms = conversion_time_ms;
+	}
+
+	if (resolution_bits > 0b11 || window_ms == 0 || period_ms < conversion_time_ms)
+	{
+		return HAL_ERROR;
+	}
+
+	HAL_StatusTypeDef status;
+	uint8_t previous_resolution_bits = this->temperature_sensor->getResolutionBits();
+
+	this->sample_count = 0;
+	this->stats = {};
+	this->stats.period_us = period_ms * 1000;
+	this->stats.min_interval_us = UINT32_MAX;
+
+	status = this->temperature_sensor->setResolutionBits(resolution_bits);
+
+	if (status != HAL_OK)
+	{
+		return status;
+	}
+
+	status = this->temperature_sensor->setContinuousConversion(true);
+
+	if (status == HAL_OK)
+	{
+		status = this->readSamples(window_ms, period_ms);
+	}
+
+	// Restore the one-shot configuration even after a failed read
+	HAL_StatusTypeDef restore_status = this->temperature_sensor->setContinuousConversion(false);
+
+	if (restore_status == HAL_OK)
+	{
+		restore_status = this->temperature_sensor->setResolutionBits(previous_resolution_bits);
+	}
+
+	return (status != HAL_OK) ? status : restore_status;
+}
+
+/**
+ * @brief Retrieves the number of readings of the last burst.
+ * @return The sample count.
+ */
+uint16_t TMP100Burst::getSampleCount()
+{
+	return this->sample_count;
+}
+
+/**
+ * @brief Retrieves a reading of the last burst.
+ * @param sample_index The index of the reading, from 0 to getSampleCount() - 1.
+ * @return The raw temperature data, or 0 if the index is out of range.
+ */
+uint16_t TMP100Burst::getSample(uint16_t sample_index)
+{
+	if (sample_index >= this->sample_count)
+	{
+		return 0;
+	}
+
+	return this->samples[sample_index];
+}
+
+/**
+ * @brief Retrieves the time of a reading of the last burst.
+ * @param sample_index The index of the reading, from 0 to getSampleCount() - 1.
+ * @return The time from the start of the continuous conversions to the read in microseconds, or 0
+ * if the index is out of range.
+ */
+uint32_t TMP100Burst::getTimestamp(uint16_t sample_index)
+{
+	if (sample_index >= this->sample_count)
+	{
+		return 0;
+	}
+
+	return this->timestamps_us[sample_index];
+}
+
+/**
+ * @brief Retrieves the timing of the reads of the last burst.
+ * @return Reference to the burst statistics.
+ */
+const TMP100BurstStats &TMP100Burst::getStats()
+{
+	return this->stats;
+}
+
+/**
+ * @brief Retrieves the achieved sample rate of the last burst, from the first to the last read.
+ * @return The sample rate in millihertz, or 0 for fewer than two readings.
+ */
+uint32_t TMP100Burst::getSampleRate()
+{
+	if (this->stats.sample_count < 2 || this->stats.duration_us == 0)
+	{
+		return 0;
+	}
+
+	return static_cast<uint64_t>(this->stats.sample_count - 1) * 1000000000 / this->stats.duration_us;
+}
+
+/**
+ * @brief Retrieves the mean deviation of the intervals between reads from the period.
+ * @return The mean jitter in microseconds, or 0 for fewer than two readings.
+ */
+uint32_t TMP100Burst::getMeanJitter()
+{
+	if (this->stats.sample_count < 2)
+	{
+		return 0;
+	}
+
+	return this->stats.total_deviation_us / (this->stats.sample_count - 1);
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Reads the Temperature Register once per period until the window has elapsed or the buffer
+ * is full. The first read follows one period after the start, once the first conversion has
+ * completed. The Pointer Register stays at the Temperature Register, so each read is a single
+ * two-byte I2C read.
+ * @param window_ms The length of the burst in milliseconds.
+ * @param period_ms The time between reads in milliseconds.
+ * @return The HAL status of the I2C reads.
+ */
+HAL_StatusTypeDef TMP100Burst::readSamples(uint32_t window_ms, uint32_t period_ms)
+{
+	HAL_StatusTypeDef status;
+	uint32_t period_cycles = period_ms * (SystemCoreClock / 1000);
+	uint32_t start_cycles = utility::getCycleCount();
+	uint32_t start_ms = HAL_GetTick();
+	uint32_t read_deadline = start_cycles + period_cycles;
+	uint32_t previous_read_cycles = start_cycles;
+	uint32_t timestamp_us = 0;
+
+	while (HAL_GetTick() - start_ms < window_ms && this->sample_count < TMP100_BURST_MAX_SAMPLES)
+	{
+		// Compare the difference so that the schedule survives the wrap-around of the cycle counter
+		while (static_cast<int32_t>(utility::getCycleCount() - read_deadline) < 0)
+		{
+		}
+
+		uint32_t read_cycles = utility::getCycleCount();
+		uint16_t temperature;
+
+		status = this->temperature_sensor->readTemperatureReg(&temperature);
+
+		if (status != HAL_OK)
+		{
+			return status;
+		}
+
+		timestamp_us += utility::convertCyclesToMicroseconds(read_cycles - previous_read_cycles);
+		previous_read_cycles = read_cycles;
+
+		if (this->sample_count > 0)
+		{
+			this->recordInterval(timestamp_us - this->timestamps_us[this->sample_count - 1]);
+		}
+
+		this->samples[this->sample_count] = temperature;
+		this->timestamps_us[this->sample_count] = timestamp_us;
+		this->sample_count++;
+		this->stats.sample_count = this->sample_count;
+		this->stats.duration_us = timestamp_us - this->timestamps_us[0];
+
+		read_deadline += period_cycles;
+
+		// Skip the slots that have already passed rather than reading them back-to-back
+		while (static_cast<int32_t>(utility::getCycleCount() - read_deadline) >= static_cast<int32_t>(period_cycles))
+		{
+			read_deadline += period_cycles;
+			this->stats.overrun_count++;
+		}
+	}
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Updates the burst statistics with the interval between two reads.
+ * @param interval_us The time between the starts of two consecutive reads in microseconds.
+ */
+void TMP100Burst::recordInterval(uint32_t interval_us)
+{
+	TMP100BurstStats &stats = this->stats;
+
+	if (interval_us < stats.min_interval_us)
+	{
+		stats.min_interval_us = interval_us;
+	}
+
+	if (interval_us > stats.max_interval_us)
+	{
+		stats.max_interval_us = interval_us;
+	}
+
+	stats.total_deviation_us += abs(static_cast<int32_t>(interval_us - stats.period_us));
+}
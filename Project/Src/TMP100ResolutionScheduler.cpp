@@ -0,0 +1,218 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TMP100ResolutionScheduler.cpp
+ * @brief Implementation file for the TMP100ResolutionScheduler class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+
+#include "TMP100ResolutionScheduler.h"
+#include "TMP100.h"
+
+// The change rate is kept with 4 extra fraction bits and smoothed over about 8 samples (alpha = 1/8)
+constexpr int CHANGE_RATE_FRACTION_BITS = 4;
+constexpr int CHANGE_RATE_SMOOTHING_SHIFT = 3;
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs a TMP100ResolutionScheduler that picks the TMP100 resolution from the readings.
+ * @param policy The thresholds of the scheduler, see TMP100ResolutionPolicy.
+ * @param resolution_bits The resolution bits the sensors are configured with.
+ */
+TMP100ResolutionScheduler::TMP100ResolutionScheduler(const TMP100ResolutionPolicy &policy, uint8_t resolution_bits) : policy(policy)
+{
+	this->resolution_bits = resolution_bits;
+	this->sensor_count = 0;
+	this->window_sample_count = 0;
+	this->window_near_alarm = false;
+	this->change_rate = 0;
+	this->change_count = 0;
+}
+
+/**
+ * @brief Updates the scheduler with the readings of a sample and selects the resolution of the
+ * next conversion.
+ * @param temperatures Pointer to the temperatures of the sample in Q8.8 format, one per sensor.
+ * @param sensor_count The number of sensors (1 to TMP100_SCHEDULER_MAX_SENSORS). A different count
+ * than in the previous sample restarts the window.
+ * @return The resolution bits for the next conversion, from 0b00 (9-bit) to 0b11 (12-bit).
+ */
+uint8_t TMP100ResolutionScheduler::update(const int16_t *temperatures, uint8_t sensor_count)
+{
+	if (sensor_count > TMP100_SCHEDULER_MAX_SENSORS)
+	{
+		sensor_count = TMP100_SCHEDULER_MAX_SENSORS;
+	}
+
+	if (sensor_count != this->sensor_count)
+	{
+		this->sensor_count = sensor_count;
+		this->change_rate = 0;
+		this->startWindow(temperatures, sensor_count);
+
+		for (uint8_t i = 0; i < sensor_count; i++)
+		{
+			this->previous_temperatures[i] = temperatures[i];
+		}
+	}
+
+	int32_t largest_change = 0;
+	int32_t largest_window_change = 0;
+
+	for (uint8_t i = 0; i < sensor_count; i++)
+	{
+		int32_t change = abs(temperatures[i] - this->previous_temperatures[i]);
+		int32_t window_change = abs(temperatures[i] - this->window_temperatures[i]);
+
+		if (change > largest_change)
+		{
+			largest_change = change;
+		}
+
+		if (window_change > largest_window_change)
+		{
+			largest_window_change = window_change;
+		}
+
+		this->previous_temperatures[i] = temperatures[i];
+	}
+
+	this->change_rate += ((largest_change << CHANGE_RATE_FRACTION_BITS) - this->change_rate) >> CHANGE_RATE_SMOOTHING_SHIFT;
+	this->window_sample_count++;
+
+	uint8_t max_resolution_bits = this->getMaxResolutionBits();
+
+	if (this->isNearAlarm(temperatures, sensor_count))
+	{
+		// Resolve a threshold crossing as finely as possible at once
+		this->window_near_alarm = true;
+		this->setResolutionBits(max_resolution_bits);
+	}
+
+	if (this->window_sample_count < this->policy.window_samples)
+	{
+		return this->resolution_bits;
+	}
+
+	if (this->window_near_alarm)
+	{
+		this->setResolutionBits(max_resolution_bits);
+	}
+	else if (this->getChangeRate() >= this->policy.fast_rate || largest_window_change < this->policy.trend_change)
+	{
+		this->setResolutionBits(this->policy.min_resolution_bits);
+	}
+	else
+	{
+		this->setResolutionBits(max_resolution_bits);
+	}
+
+	this->startWindow(temperatures, sensor_count);
+
+	return this->resolution_bits;
+}
+
+/**
+ * @brief Retrieves the resolution selected by the last update.
+ * @return The resolution bits, from 0b00 (9-bit) to 0b11 (12-bit).
+ */
+uint8_t TMP100ResolutionScheduler::getResolutionBits()
+{
+	return this->resolution_bits;
+}
+
+/**
+ * @brief Retrieves the smoothed largest change of any sensor between two samples.
+ * @return The change rate in Q8.8 format per sample.
+ */
+int16_t TMP100ResolutionScheduler::getChangeRate()
+{
+	return this->change_rate >> CHANGE_RATE_FRACTION_BITS;
+}
+
+/**
+ * @brief Retrieves the number of resolution changes since construction.
+ * @return The change count.
+ */
+uint32_t TMP100ResolutionScheduler::getChangeCount()
+{
+	return this->change_count;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Retrieves the highest resolution whose conversion fits into the conversion budget.
+ * @return The resolution bits, at least the minimum resolution of the policy.
+ */
+uint8_t TMP100ResolutionScheduler::getMaxResolutionBits()
+{
+	uint8_t resolution_bits = this->policy.max_resolution_bits;
+
+	while (resolution_bits > this->policy.min_resolution_bits &&
+		   TMP100::getConversionTime(resolution_bits) > this->policy.conversion_budget_ms)
+	{
+		resolution_bits--;
+	}
+
+	return resolution_bits;
+}
+
+/**
+ * @brief Checks whether any temperature of a sample is within the alarm margin of a threshold.
+ * @param temperatures Pointer to the temperatures of the sample in Q8.8 format.
+ * @param sensor_count The number of sensors.
+ * @return True if a sensor is near an alarm threshold, false otherwise.
+ */
+bool TMP100ResolutionScheduler::isNearAlarm(const int16_t *temperatures, uint8_t sensor_count)
+{
+	for (uint8_t i = 0; i < sensor_count; i++)
+	{
+		if (abs(temperatures[i] - this->policy.alarm_low) <= this->policy.alarm_margin ||
+			abs(temperatures[i] - this->policy.alarm_high) <= this->policy.alarm_margin)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Selects a resolution and counts the change.
+ * @param resolution_bits The resolution bits, from 0b00 (9-bit) to 0b11 (12-bit).
+ */
+void TMP100ResolutionScheduler::setResolutionBits(uint8_t resolution_bits)
+{
+	if (resolution_bits != this->resolution_bits)
+	{
+		this->resolution_bits = resolution_bits;
+		this->change_count++;
+	}
+}
+
+/**
+ * @brief Starts a new decision window at the current sample.
+ * @param temperatures Pointer to the temperatures of the sample in Q8.8 format.
+ * @param sensor_count The number of sensors.
+ */
+void TMP100ResolutionScheduler::startWindow(const int16_t *temperatures, uint8_t sensor_count)
+{
+	for (uint8_t i = 0; i < sensor_count; i++)
+	{
+		this->window_temperatures[i] = temperatures[i];
+	}
+
+	this->window_sample_count = 0;
+	this->window_near_alarm = false;
+}
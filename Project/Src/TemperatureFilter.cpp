@@ -0,0 +1,220 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file TemperatureFilter.cpp
+ * @brief Implementation file for the TemperatureFilter class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "TemperatureFilter.h"
+
+// Extra fraction bits of the EWMA state, so that steps smaller than N LSB are not lost to rounding
+constexpr int EWMA_FRACTION_BITS = 8;
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs a TemperatureFilter for a stream of samples of one sensor.
+ * @param type The filter type, see FilterType.
+ * @param length The window of the moving average and median filters (1 to FILTER_MAX_LENGTH), or N
+ * of the EWMA filter, rounded down to a power of two (alpha = 1/N). Out-of-range lengths are clamped.
+ */
+TemperatureFilter::TemperatureFilter(FilterType type, uint8_t length) : type(type)
+{
+    if (length == 0)
+    {
+        length = 1;
+    }
+    else if (length > FILTER_MAX_LENGTH)
+    {
+        length = FILTER_MAX_LENGTH;
+    }
+
+    this->ewma_shift = 31 - __builtin_clz(length);
+
+    if (type == FilterType::EWMA)
+    {
+        length = 1 << this->ewma_shift;
+    }
+
+    this->length = length;
+    this->reset();
+}
+
+/**
+ * @brief Adds a sample to the filter and retrieves the filtered value. Until the window is full,
+ * the moving average and the median are taken over the samples so far, and the EWMA filter starts
+ * from the first sample.
+ * @param sample The temperature in Q8.8 format.
+ * @return The filtered temperature in Q8.8 format, rounded to the nearest LSB.
+ */
+int16_t TemperatureFilter::update(int16_t sample)
+{
+    switch (this->type)
+    {
+    case FilterType::MovingAverage:
+        return this->updateMovingAverage(sample);
+    case FilterType::Median:
+        return this->updateMedian(sample);
+    case FilterType::EWMA:
+        return this->updateEWMA(sample);
+    default:
+        return sample;
+    }
+}
+
+/**
+ * @brief Discards all samples, e.g. after a sensor stopped responding or changed its resolution.
+ */
+void TemperatureFilter::reset()
+{
+    this->sample_count = 0;
+    this->window_index = 0;
+    this->window_sum = 0;
+    this->ewma_state = 0;
+}
+
+/**
+ * @brief Checks whether the filter has seen enough samples for its full window.
+ * @return True once length samples have been added since construction or the last reset.
+ */
+bool TemperatureFilter::isSettled()
+{
+    return this->sample_count >= this->length;
+}
+
+/**
+ * @brief Retrieves the filter type.
+ * @return The filter type passed to the constructor.
+ */
+FilterType TemperatureFilter::getType()
+{
+    return this->type;
+}
+
+/**
+ * @brief Retrieves the filter length after clamping.
+ * @return The window length, or N of the EWMA filter.
+ */
+uint8_t TemperatureFilter::getLength()
+{
+    return this->length;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Updates the running sum of the window with a sample and calculates the mean.
+ * @param sample The temperature in Q8.8 format.
+ * @return The mean of the window, rounded half away from zero.
+ */
+int16_t TemperatureFilter::updateMovingAverage(int16_t sample)
+{
+    if (this->sample_count == this->length)
+    {
+        this->window_sum -= this->window[this->window_index];
+    }
+    else
+    {
+        this->sample_count++;
+    }
+
+    this->window[this->window_index] = sample;
+    this->window_sum += sample;
+    this->window_index = (this->window_index + 1 == this->length) ? 0 : this->window_index + 1;
+
+    int32_t half = this->sample_count / 2;
+    int32_t rounded_sum = (this->window_sum >= 0) ? this->window_sum + half : this->window_sum - half;
+
+    return static_cast<int16_t>(rounded_sum / this->sample_count);
+}
+
+/**
+ * @brief Replaces the oldest sample of the sorted window with a sample, keeping the window sorted
+ * with one pass of insertion sort (at most N moves), and retrieves the median.
+ * @param sample The temperature in Q8.8 format.
+ * @return The median of the window; for an even number of samples the mean of the two middle
+ * samples, rounded towards negative infinity.
+ */
+int16_t TemperatureFilter::updateMedian(int16_t sample)
+{
+    int16_t *sorted_window = this->sorted_window;
+    uint8_t position;
+
+    if (this->sample_count == this->length)
+    {
+        // Remove the oldest sample by moving the larger samples down over it
+        int16_t oldest = this->window[this->window_index];
+        position = 0;
+
+        while (sorted_window[position] != oldest)
+        {
+            position++;
+        }
+
+        for (; position + 1 < this->sample_count; position++)
+        {
+            sorted_window[position] = sorted_window[position + 1];
+        }
+
+        position = this->sample_count - 1;
+    }
+    else
+    {
+        position = this->sample_count++;
+    }
+
+    // Insert the new sample by moving the larger samples up
+    while (position > 0 && sorted_window[position - 1] > sample)
+    {
+        sorted_window[position] = sorted_window[position - 1];
+        position--;
+    }
+
+    sorted_window[position] = sample;
+    this->window[this->window_index] = sample;
+    this->window_index = (this->window_index + 1 == this->length) ? 0 : this->window_index + 1;
+
+    uint8_t middle = this->sample_count / 2;
+
+    if (this->sample_count & 1)
+    {
+        return sorted_window[middle];
+    }
+
+    return (sorted_window[middle - 1] + sorted_window[middle]) >> 1;
+}
+
+/**
+ * @brief Moves the EWMA state towards a sample by 1/N of the difference.
+ * @param sample The temperature in Q8.8 format.
+ * @return The EWMA state rounded to Q8.8.
+ */
+int16_t TemperatureFilter::updateEWMA(int16_t sample)
+{
+    int32_t scaled_sample = static_cast<int32_t>(sample) * (1 << EWMA_FRACTION_BITS);
+
+    if (this->sample_count == 0)
+    {
+        this->ewma_state = scaled_sample;
+        this->sample_count = 1;
+    }
+    else
+    {
+        this->ewma_state += (scaled_sample - this->ewma_state) >> this->ewma_shift;
+
+        if (this->sample_count < this->length)
+        {
+            this->sample_count++;
+        }
+    }
+
+    return static_cast<int16_t>((this->ewma_state + (1 << (EWMA_FRACTION_BITS - 1))) >> EWMA_FRACTION_BITS);
+}
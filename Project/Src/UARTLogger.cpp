@@ -0,0 +1,516 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file UARTLogger.cpp
+ * @brief Implementation file for the UARTLogger class.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "UARTLogger.h"
+
+// The ring buffer holds, in this order from the oldest byte on: the bytes of the DMA transfer in
+// progress, the pending bytes, and the free space, the start of which is handed out by reserve
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructs a UARTLogger that buffers messages in RAM and sends them via DMA on the
+ * specified UART, and registers it for the HAL UART callbacks of that UART. utility::logMessage
+ * writes to the registered logger of a UART instead of blocking.
+ * @param uart_handle Pointer to the UART handle used for transmission. DMA must be linked to its
+ * TX stream and the UART interrupt must be enabled.
+ * @param overflow_policy The handling of messages that do not fit, see UARTOverflowPolicy.
+ */
+UARTLogger::UARTLogger(UART_HandleTypeDef *uart_handle, UARTOverflowPolicy overflow_policy)
+    : uart_handle(uart_handle), overflow_policy(overflow_policy)
+{
+    this->used_count = 0;
+    this->pending_index = 0;
+    this->pending_count = 0;
+    this->transfer_length = 0;
+    this->peak_used_count = 0;
+    this->dropped_byte_count = 0;
+
+    for (UARTLogger *&instance : instances)
+    {
+        if (instance == nullptr || instance->uart_handle == uart_handle)
+        {
+            instance = this;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Selects the handling of messages that do not fit into the free part of the ring buffer.
+ * @param overflow_policy The overflow policy, see UARTOverflowPolicy.
+ */
+void UARTLogger::setOverflowPolicy(UARTOverflowPolicy overflow_policy)
+{
+    this->overflow_policy = overflow_policy;
+}
+
+/**
+ * @brief Copies a message into the ring buffer and starts a DMA transfer if none is in progress.
+ * Returns as soon as the message is buffered; with the Block policy it first waits for the space.
+ * @param data Pointer to the message.
+ * @param length The number of bytes of the message.
+ * @return HAL_OK if the whole message was buffered, HAL_BUSY if bytes were dropped (counted in the
+ * dropped byte count), or HAL_ERROR if the data pointer is invalid.
+ */
+HAL_StatusTypeDef UARTLogger::write(const uint8_t *data, uint16_t length)
+{
+    if (data == nullptr)
+    {
+        return HAL_ERROR;
+    }
+
+    while (length > 0)
+    {
+        uint16_t chunk_length = (length < UART_LOGGER_MAX_MESSAGE_LENGTH) ? length : UART_LOGGER_MAX_MESSAGE_LENGTH;
+        uint16_t reserved_length;
+        char *destination = this->reserve(chunk_length, &reserved_length);
+
+        if (reserved_length > chunk_length)
+        {
+            reserved_length = chunk_length;
+        }
+
+        memcpy(destination, data, reserved_length);
+        this->commit(reserved_length);
+        data += reserved_length;
+        length -= reserved_length;
+
+        if (reserved_length < chunk_length && this->overflow_policy != UARTOverflowPolicy::Block)
+        {
+            this->dropped_byte_count += length;
+            return HAL_BUSY;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Copies a binary frame into the ring buffer as a whole or not at all, so that the overflow
+ * policy never sends a truncated frame, and starts a DMA transfer if none is in progress.
+ * @param data Pointer to the frame.
+ * @param length The number of bytes of the frame, at most UART_LOGGER_MAX_MESSAGE_LENGTH.
+ * @return HAL_OK if the frame was buffered, HAL_BUSY if it was dropped (counted in the dropped byte
+ * count), or HAL_ERROR if the data pointer or the length is invalid.
+ */
+HAL_StatusTypeDef UARTLogger::writeFrame(const uint8_t *data, uint16_t length)
+{
+    if (data == nullptr || length > UART_LOGGER_MAX_MESSAGE_LENGTH)
+    {
+        return HAL_ERROR;
+    }
+
+    uint16_t reserved_length;
+    char *destination = this->reserve(length, &reserved_length);
+
+    if (reserved_length < length)
+    {
+        this->dropped_byte_count += length;
+        return HAL_BUSY;
+    }
+
+    memcpy(destination, data, length);
+    this->commit(length);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Formats a message directly into the ring buffer with vsnprintf, see the overload taking a
+ * UARTMessageFormatter.
+ * @param format The printf-style format string.
+ * @param arguments The arguments of the format string.
+ * @return HAL_OK if the whole message was buffered, HAL_BUSY if it was truncated, or HAL_ERROR if
+ * formatting failed.
+ */
+HAL_StatusTypeDef UARTLogger::writeFormatted(const char *format, va_list arguments)
+{
+    PrintfContext context;
+    context.format = format;
+    va_copy(context.arguments, arguments);
+
+    HAL_StatusTypeDef status = this->writeFormatted(formatPrintfMessage, &context);
+
+    va_end(context.arguments);
+
+    return status;
+}
+
+/**
+ * @brief Formats a message directly into the ring buffer, without an intermediate copy, and starts
+ * a DMA transfer if none is in progress. The message is formatted once into the free space; only a
+ * message that does not fit into it is formatted a second time after the overflow policy made room.
+ * @param formatter The function that formats the message, see UARTMessageFormatter.
+ * @param context Pointer passed to the formatter.
+ * @return HAL_OK if the whole message was buffered, HAL_BUSY if it was truncated (the missing bytes
+ * are counted in the dropped byte count), or HAL_ERROR if formatting failed.
+ */
+HAL_StatusTypeDef UARTLogger::writeFormatted(UARTMessageFormatter formatter, void *context)
+{
+    uint16_t reserved_length;
+    char *destination = this->reserve(1, &reserved_length);
+    int text_length = formatter(destination, reserved_length, context);
+
+    if (text_length >= reserved_length && reserved_length < UART_LOGGER_MAX_MESSAGE_LENGTH &&
+        this->overflow_policy != UARTOverflowPolicy::DropNewest)
+    {
+        // Make room for the whole message (and the terminating null character) and format it again
+        destination = this->reserve(text_length + 1, &reserved_length);
+        text_length = formatter(destination, reserved_length, context);
+    }
+
+    if (text_length < 0)
+    {
+        return HAL_ERROR;
+    }
+
+    // The terminating null character stays in the free space behind the message
+    uint16_t committed_length = text_length;
+
+    if (text_length >= reserved_length)
+    {
+        committed_length = (reserved_length > 0) ? reserved_length - 1 : 0;
+    }
+
+    this->commit(committed_length);
+
+    if (committed_length < text_length)
+    {
+        this->dropped_byte_count += text_length - committed_length;
+        return HAL_BUSY;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Reserves contiguous space behind the pending bytes for a message to be written in place,
+ * e.g. by snprintf. The overflow policy applies when less than the requested length is free. The
+ * space is sent once the written part is committed; only one reservation may be open at a time, and
+ * not from interrupt handlers.
+ * @param length The number of bytes to make room for, up to UART_LOGGER_MAX_MESSAGE_LENGTH.
+ * @param reserved_length Pointer to a variable where the number of bytes that may be written will
+ * be stored: all free bytes up to UART_LOGGER_MAX_MESSAGE_LENGTH, which may be less than the
+ * requested length with the DropNewest policy (or zero).
+ * @return Pointer to the reserved space.
+ */
+char *UARTLogger::reserve(uint16_t length, uint16_t *reserved_length)
+{
+    if (length > UART_LOGGER_MAX_MESSAGE_LENGTH)
+    {
+        length = UART_LOGGER_MAX_MESSAGE_LENGTH;
+    }
+
+    // The transfer complete interrupt also moves the indices and starts transfers
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    while (this->overflow_policy == UARTOverflowPolicy::Block && UART_LOGGER_BUFFER_SIZE - this->used_count < length)
+    {
+        // Wait for the transfer in progress to free some space (without one, retry starting it)
+        if (this->transfer_length == 0)
+        {
+            this->startTransfer();
+        }
+
+        __set_PRIMASK(primask);
+        __disable_irq();
+    }
+
+    uint16_t free_count = UART_LOGGER_BUFFER_SIZE - this->used_count;
+
+    if (length > free_count && this->overflow_policy == UARTOverflowPolicy::DropOldest)
+    {
+        this->dropOldestBytes(length - free_count);
+        free_count = UART_LOGGER_BUFFER_SIZE - this->used_count;
+    }
+
+    uint16_t write_index = (this->pending_index + this->pending_count) % UART_LOGGER_BUFFER_SIZE;
+
+    __set_PRIMASK(primask);
+
+    *reserved_length = (free_count < UART_LOGGER_MAX_MESSAGE_LENGTH) ? free_count : UART_LOGGER_MAX_MESSAGE_LENGTH;
+
+    return reinterpret_cast<char *>(&this->buffer[write_index]);
+}
+
+/**
+ * @brief Appends the first bytes of the reserved space to the pending bytes and starts a DMA
+ * transfer if none is in progress. Bytes written past the end of the ring buffer are moved to its
+ * start.
+ * @param length The number of bytes written, at most the reserved length.
+ */
+void UARTLogger::commit(uint16_t length)
+{
+    uint16_t write_index = (this->pending_index + this->pending_count) % UART_LOGGER_BUFFER_SIZE;
+
+    if (write_index + length > UART_LOGGER_BUFFER_SIZE)
+    {
+        // The start of the ring buffer is free space, which the interrupt does not touch
+        memcpy(&this->buffer[0], &this->buffer[UART_LOGGER_BUFFER_SIZE], write_index + length - UART_LOGGER_BUFFER_SIZE);
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    this->pending_count += length;
+    this->used_count += length;
+
+    if (this->used_count > this->peak_used_count)
+    {
+        this->peak_used_count = this->used_count;
+    }
+
+    if (this->transfer_length == 0)
+    {
+        this->startTransfer();
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Waits until all buffered bytes have been sent, e.g. before a reset or a long blocking
+ * section.
+ * @param timeout_ms The maximum time to wait in milliseconds.
+ * @return HAL_OK once the ring buffer is empty, or HAL_TIMEOUT.
+ */
+HAL_StatusTypeDef UARTLogger::flush(uint32_t timeout_ms)
+{
+    uint32_t start_ms = HAL_GetTick();
+
+    while (this->used_count > 0)
+    {
+        if (HAL_GetTick() - start_ms >= timeout_ms)
+        {
+            return HAL_TIMEOUT;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Retrieves the number of bytes in the ring buffer, including the transfer in progress.
+ * @return The buffered byte count.
+ */
+uint16_t UARTLogger::getBufferedByteCount()
+{
+    return this->used_count;
+}
+
+/**
+ * @brief Retrieves the largest number of bytes held in the ring buffer since construction, to size
+ * the buffer against the output bursts.
+ * @return The peak buffered byte count.
+ */
+uint16_t UARTLogger::getPeakBufferedByteCount()
+{
+    return this->peak_used_count;
+}
+
+/**
+ * @brief Retrieves the number of bytes dropped by the overflow policy or lost to transfer errors.
+ * @return The dropped byte count since construction.
+ */
+uint32_t UARTLogger::getDroppedByteCount()
+{
+    return this->dropped_byte_count;
+}
+
+/**
+ * @brief Releases the bytes of the completed DMA transfer and starts the transfer of the next
+ * pending bytes. Called from HAL_UART_TxCpltCallback.
+ */
+void UARTLogger::handleTransferComplete()
+{
+    this->releaseTransfer();
+    this->startTransfer();
+}
+
+/**
+ * @brief Counts the bytes of the aborted DMA transfer as dropped and continues with the next
+ * pending bytes. Called from HAL_UART_ErrorCallback, which also reports receive errors while the
+ * transfer is still running; these are ignored.
+ */
+void UARTLogger::handleTransferError()
+{
+    if (this->transfer_length == 0 || this->uart_handle->gState == HAL_UART_STATE_BUSY_TX)
+    {
+        return;
+    }
+
+    this->dropped_byte_count += this->transfer_length;
+    this->releaseTransfer();
+    this->startTransfer();
+}
+
+/**
+ * @brief Retrieves the UARTLogger registered for a UART.
+ * @param uart_handle Pointer to the UART handle.
+ * @return Pointer to the UARTLogger, or nullptr if none was constructed for this UART.
+ */
+UARTLogger *UARTLogger::getInstance(UART_HandleTypeDef *uart_handle)
+{
+    for (UARTLogger *instance : instances)
+    {
+        if (instance != nullptr && instance->uart_handle == uart_handle)
+        {
+            return instance;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Drops the oldest pending bytes. The bytes of the transfer in progress cannot be dropped,
+ * so the remaining pending bytes are moved down behind them to free the space right away (at most
+ * one buffer length of byte moves). Must be called with interrupts disabled.
+ * @param length The number of bytes to drop.
+ */
+void UARTLogger::dropOldestBytes(uint16_t length)
+{
+    if (length > this->pending_count)
+    {
+        length = this->pending_count;
+    }
+
+    this->pending_count -= length;
+    this->used_count -= length;
+    this->dropped_byte_count += length;
+
+    if (this->transfer_length == 0)
+    {
+        this->pending_index = (this->pending_index + length) % UART_LOGGER_BUFFER_SIZE;
+        return;
+    }
+
+    for (uint16_t i = 0; i < this->pending_count; i++)
+    {
+        this->buffer[(this->pending_index + i) % UART_LOGGER_BUFFER_SIZE] =
+            this->buffer[(this->pending_index + length + i) % UART_LOGGER_BUFFER_SIZE];
+    }
+}
+
+/**
+ * @brief Starts the DMA transfer of the pending bytes up to the end of the ring buffer, if no
+ * transfer is in progress. Must be called with interrupts disabled or from the UART interrupt.
+ */
+void UARTLogger::startTransfer()
+{
+    if (this->transfer_length > 0 || this->pending_count == 0)
+    {
+        return;
+    }
+
+    uint16_t length = UART_LOGGER_BUFFER_SIZE - this->pending_index;
+
+    if (length > this->pending_count)
+    {
+        length = this->pending_count;
+    }
+
+    // Set before starting the transfer, since the completion interrupt may fire right away
+    uint16_t transfer_index = this->pending_index;
+    this->transfer_length = length;
+    this->pending_index = (this->pending_index + length) % UART_LOGGER_BUFFER_SIZE;
+    this->pending_count -= length;
+
+    if (HAL_UART_Transmit_DMA(this->uart_handle, &this->buffer[transfer_index], length) != HAL_OK)
+    {
+        // Leave the bytes pending; the next write retries the transfer
+        this->pending_index = transfer_index;
+        this->pending_count += length;
+        this->transfer_length = 0;
+    }
+}
+
+/**
+ * @brief Frees the bytes of the finished transfer.
+ */
+void UARTLogger::releaseTransfer()
+{
+    this->used_count -= this->transfer_length;
+    this->transfer_length = 0;
+}
+
+/**
+ * @brief Formats a message with vsnprintf, as the UARTMessageFormatter of the printf-style
+ * writeFormatted. Each call formats from a copy of the arguments, so that it can be repeated.
+ * @param buffer Pointer to the buffer where the message will be stored.
+ * @param buffer_size The size of the buffer in bytes.
+ * @param context Pointer to the PrintfContext with the format string and its arguments.
+ * @return The length of the complete message, or a negative value on error.
+ */
+int UARTLogger::formatPrintfMessage(char *buffer, size_t buffer_size, void *context)
+{
+    PrintfContext *printf_context = static_cast<PrintfContext *>(context);
+    va_list arguments;
+
+    va_copy(arguments, printf_context->arguments);
+    int text_length = vsnprintf(buffer, buffer_size, printf_context->format, arguments);
+    va_end(arguments);
+
+    return text_length;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Static_Members Static Members
+ * ------------------------------------------------------------------------------------------------
+ */
+
+UARTLogger *UARTLogger::instances[6] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section HAL_Callbacks HAL Callbacks
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Overrides the weak HAL callback for a completed transmit in interrupt or DMA mode.
+ * @param huart Pointer to the UART handle.
+ */
+extern "C" void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    UARTLogger *instance = UARTLogger::getInstance(huart);
+
+    if (instance != nullptr)
+    {
+        instance->handleTransferComplete();
+    }
+}
+
+/**
+ * @brief Overrides the weak HAL callback for UART errors in interrupt or DMA mode.
+ * @param huart Pointer to the UART handle.
+ */
+extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    UARTLogger *instance = UARTLogger::getInstance(huart);
+
+    if (instance != nullptr)
+    {
+        instance->handleTransferError();
+    }
+}
@@ -0,0 +1,663 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_benchmark.cpp
+ * @brief Implementation file for on-target benchmark routines. Results are logged via UART.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "project_benchmark.h"
+#include "project_utility.h"
+#include "project_codec.h"
+#include "project_tokenlog.h"
+#include "UARTLogger.h"
+
+// Buffer size
+constexpr uint16_t READ_BUFFER_SIZE = 256;
+
+// Register reads per measurement of the I2C read benchmark, and the bus clock speeds it compares
+constexpr uint32_t I2C_BENCHMARK_READ_COUNT = 64;
+constexpr uint32_t I2C_BENCHMARK_CLOCK_SPEEDS[] = {100000, 400000};
+
+// Temperature range of the TMP100 in Q8.8 format, covered by the temperature format benchmark
+constexpr int32_t TMP100_MIN_Q8_8 = -55 * 256;
+constexpr int32_t TMP100_MAX_Q8_8 = 125 * 256;
+
+// Synthetic input of the filter benchmark: 23C with up to +-2 LSB of 12-bit noise (1/16C per LSB) and a 2C spike
+// every FILTER_BENCHMARK_SPIKE_INTERVAL samples; the first FILTER_MAX_LENGTH outputs are skipped for the peak-to-peak value
+constexpr uint32_t FILTER_BENCHMARK_SAMPLE_COUNT = 1024;
+constexpr int16_t FILTER_BENCHMARK_BASE_Q8_8 = 23 * 256;
+constexpr int16_t FILTER_BENCHMARK_NOISE_LSB = 2;
+constexpr int16_t FILTER_BENCHMARK_LSB_Q8_8 = 16;
+constexpr int16_t FILTER_BENCHMARK_SPIKE_Q8_8 = 2 * 256;
+constexpr uint32_t FILTER_BENCHMARK_SPIKE_INTERVAL = 64;
+
+// Filters compared by the filter benchmark, each at both lengths
+constexpr FilterType FILTER_BENCHMARK_TYPES[] = {FilterType::None, FilterType::MovingAverage, FilterType::Median, FilterType::EWMA};
+constexpr const char *FILTER_BENCHMARK_NAMES[] = {"none", "average", "median", "ewma"};
+constexpr uint8_t FILTER_BENCHMARK_LENGTHS[] = {4, 16};
+
+// Status lines per measurement of the UART log benchmark, and the time to wait for them to be sent
+constexpr uint32_t UART_BENCHMARK_LINE_COUNT = 8;
+constexpr uint32_t UART_BENCHMARK_FLUSH_TIMEOUT_MS = 1000;
+
+// Temperature lines per measurement of the token log benchmark, from 20C in steps of 1/16C
+constexpr uint32_t TOKEN_BENCHMARK_MESSAGE_COUNT = 64;
+constexpr int32_t TOKEN_BENCHMARK_BASE_Q8_8 = 20 * 256;
+
+// Samples per second a full-chip dump sends at 115200 baud (8N1) with two bytes per sample
+constexpr uint32_t UART_DUMP_SAMPLES_PER_SECOND = 115200 / 10 / 2;
+
+using utility::getI2CReadAddress, utility::getI2CWriteAddress, utility::logFormattedMessage, utility::logStatusMessage;
+
+namespace
+{
+    // Decode statistics collected over a log scan
+    struct DecodeBenchmarkContext
+    {
+        EEPROMLog *eeprom_log;
+        uint32_t sample_count;
+        uint32_t decode_cycles;
+    };
+
+    // Delta stream built from the recorded samples, one simulated record payload at a time
+    struct DeltaBenchmarkContext
+    {
+        EEPROMLog *eeprom_log;
+        uint8_t payload[LOG_RECORD_PAYLOAD_SIZE];
+        DeltaStreamState state;
+        uint8_t record_sample_count;
+        uint8_t bit_width;
+        uint32_t sample_count;
+        uint32_t record_count;
+        uint32_t encode_cycles;
+    };
+
+    /**
+     * @brief Decodes the samples of a record and accumulates the cycles spent decoding.
+     * @param record The decoded record.
+     * @param context Pointer to a DecodeBenchmarkContext.
+     */
+    void decodeRecordSamples(const LogRecord &record, void *context)
+    {
+        DecodeBenchmarkContext *benchmark_context = static_cast<DecodeBenchmarkContext *>(context);
+        uint16_t samples[LOG_RECORD_MAX_SAMPLES];
+
+        uint32_t start_cycles = utility::getCycleCount();
+        uint8_t sample_count = benchmark_context->eeprom_log->decodeSamples(record, samples);
+        benchmark_context->decode_cycles += utility::getCycleCount() - start_cycles;
+        benchmark_context->sample_count += sample_count;
+    }
+
+    /**
+     * @brief Measures the average time of a two-byte register read, either as a STOP-terminated
+     * register address write followed by a separate read, or as one combined transfer with a
+     * repeated START. Requires the cycle counter to be enabled.
+     * @param i2c_handle Pointer to the I2C handle used for communication.
+     * @param i2c_address The 7-bit I2C address of the device.
+     * @param reg_address The register or memory address to read from.
+     * @param reg_address_size The size of the address: I2C_MEMADD_SIZE_8BIT or I2C_MEMADD_SIZE_16BIT.
+     * @param combined True to measure the combined transfer, false for the separate transactions.
+     * @param read_us Pointer to a variable where the average time per read in microseconds will be stored.
+     * @return The HAL status of the I2C operations.
+     */
+    HAL_StatusTypeDef measureRegisterRead(I2C_HandleTypeDef *i2c_handle, uint8_t i2c_address, uint16_t reg_address,
+                                          uint16_t reg_address_size, bool combined, uint32_t *read_us)
+    {
+        HAL_StatusTypeDef status = HAL_OK;
+        uint8_t address_buffer[2];
+        uint16_t address_length = (reg_address_size == I2C_MEMADD_SIZE_16BIT) ? 2 : 1;
+        uint8_t buffer[2];
+
+        if (address_length == 2)
+        {
+            address_buffer[0] = reg_address >> 8;
+            address_buffer[1] = reg_address;
+        }
+        else
+        {
+            address_buffer[0] = reg_address;
+        }
+
+        uint32_t start_cycles = utility::getCycleCount();
+
+        for (uint32_t i = 0; i < I2C_BENCHMARK_READ_COUNT && status == HAL_OK; i++)
+        {
+            if (combined)
+            {
+                status = HAL_I2C_Mem_Read(i2c_handle, getI2CWriteAddress(i2c_address), reg_address, reg_address_size,
+                                          buffer, sizeof(buffer), HAL_MAX_DELAY);
+                continue;
+            }
+
+            status = HAL_I2C_Master_Transmit(i2c_handle, getI2CWriteAddress(i2c_address), address_buffer,
+                                             address_length, HAL_MAX_DELAY);
+
+            if (status == HAL_OK)
+            {
+                status = HAL_I2C_Master_Receive(i2c_handle, getI2CReadAddress(i2c_address), buffer, sizeof(buffer),
+                                                HAL_MAX_DELAY);
+            }
+        }
+
+        uint32_t elapsed_cycles = utility::getCycleCount() - start_cycles;
+        *read_us = utility::convertCyclesToMicroseconds(elapsed_cycles) / I2C_BENCHMARK_READ_COUNT;
+
+        return status;
+    }
+
+    /**
+     * @brief Calculates a throughput in bytes per second, guarding against a zero elapsed time.
+     * @param byte_count The number of bytes transferred.
+     * @param elapsed_ms The elapsed time in milliseconds.
+     * @return The throughput in bytes per second.
+     */
+    uint32_t calculateBytesPerSecond(uint32_t byte_count, uint32_t elapsed_ms)
+    {
+        if (elapsed_ms == 0)
+        {
+            elapsed_ms = 1;
+        }
+
+        return static_cast<uint32_t>((static_cast<uint64_t>(byte_count) * 1000) / elapsed_ms);
+    }
+
+    /**
+     * @brief Re-encodes the samples of a recorded log record into delta stream payloads and
+     * accumulates the cycles spent encoding. A new payload, and with it a keyframe, is started
+     * whenever the current one is full.
+     * @param record The decoded record.
+     * @param context Pointer to a DeltaBenchmarkContext.
+     */
+    void encodeRecordSamples(const LogRecord &record, void *context)
+    {
+        DeltaBenchmarkContext *benchmark_context = static_cast<DeltaBenchmarkContext *>(context);
+        uint16_t samples[LOG_RECORD_MAX_SAMPLES];
+        uint8_t sample_count = benchmark_context->eeprom_log->decodeSamples(record, samples);
+        uint8_t bit_width = benchmark_context->bit_width;
+
+        for (uint8_t i = 0; i < sample_count; i++)
+        {
+            uint16_t value = samples[i] >> (16 - bit_width);
+            uint32_t start_cycles = utility::getCycleCount();
+            bool appended = false;
+
+            if (benchmark_context->record_sample_count > 0 && benchmark_context->record_sample_count < LOG_RECORD_MAX_SAMPLES)
+            {
+                appended = codec::appendDeltaSample(benchmark_context->payload, LOG_RECORD_PAYLOAD_SIZE * 8, value, bit_width,
+                                                    &benchmark_context->state);
+            }
+
+            if (!appended)
+            {
+                codec::startDeltaStream(benchmark_context->payload, value, bit_width, 1, &benchmark_context->state);
+                benchmark_context->record_sample_count = 0;
+                benchmark_context->record_count++;
+            }
+
+            benchmark_context->encode_cycles += utility::getCycleCount() - start_cycles;
+            benchmark_context->record_sample_count++;
+            benchmark_context->sample_count++;
+        }
+    }
+}
+
+namespace benchmark
+{
+    /**
+     * @brief Measures the bus time of TMP100 temperature reads and EEPROM word reads at 100 kHz and
+     * 400 kHz, once as separate address write and read transactions and once combined with a
+     * repeated START, and logs the average time per read. The I2C clock speed is restored
+     * afterwards. Must run before a TMP100 object starts tracking the Pointer Register of the
+     * sensor, and requires the cycle counter to be enabled.
+     * @param i2c_handle Pointer to the I2C handle shared by both devices.
+     * @param tmp100_i2c_address The 7-bit I2C address of the TMP100.
+     * @param eeprom_i2c_address The 7-bit I2C address of the 24FC256.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runI2CReadBenchmark(I2C_HandleTypeDef *i2c_handle, uint8_t tmp100_i2c_address, uint8_t eeprom_i2c_address,
+                             UART_HandleTypeDef *uart_handle)
+    {
+        uint32_t original_clock_speed = i2c_handle->Init.ClockSpeed;
+
+        for (uint32_t clock_speed : I2C_BENCHMARK_CLOCK_SPEEDS)
+        {
+            HAL_StatusTypeDef status;
+            uint32_t tmp100_split_us = 0;
+            uint32_t tmp100_combined_us = 0;
+            uint32_t eeprom_split_us = 0;
+            uint32_t eeprom_combined_us = 0;
+
+            i2c_handle->Init.ClockSpeed = clock_speed;
+            status = HAL_I2C_Init(i2c_handle);
+
+            // The TMP100 Temperature Register (8-bit pointer) and the first EEPROM word (16-bit address)
+            if (status == HAL_OK)
+            {
+                status = measureRegisterRead(i2c_handle, tmp100_i2c_address, 0x00, I2C_MEMADD_SIZE_8BIT, false, &tmp100_split_us);
+            }
+
+            if (status == HAL_OK)
+            {
+                status = measureRegisterRead(i2c_handle, tmp100_i2c_address, 0x00, I2C_MEMADD_SIZE_8BIT, true, &tmp100_combined_us);
+            }
+
+            if (status == HAL_OK)
+            {
+                status = measureRegisterRead(i2c_handle, eeprom_i2c_address, 0x0000, I2C_MEMADD_SIZE_16BIT, false, &eeprom_split_us);
+            }
+
+            if (status == HAL_OK)
+            {
+                status = measureRegisterRead(i2c_handle, eeprom_i2c_address, 0x0000, I2C_MEMADD_SIZE_16BIT, true, &eeprom_combined_us);
+            }
+
+            if (status != HAL_OK)
+            {
+                logFormattedMessage(uart_handle, "Error: I2C read benchmark failed at %lu kHz!\r\n",
+                                    static_cast<unsigned long>(clock_speed / 1000));
+                break;
+            }
+
+            logFormattedMessage(uart_handle, "TMP100 read @ %lu kHz: %lu us split, %lu us combined.\r\n",
+                                static_cast<unsigned long>(clock_speed / 1000), static_cast<unsigned long>(tmp100_split_us),
+                                static_cast<unsigned long>(tmp100_combined_us));
+
+            logFormattedMessage(uart_handle, "EEPROM read @ %lu kHz: %lu us split, %lu us combined.\r\n",
+                                static_cast<unsigned long>(clock_speed / 1000), static_cast<unsigned long>(eeprom_split_us),
+                                static_cast<unsigned long>(eeprom_combined_us));
+        }
+
+        i2c_handle->Init.ClockSpeed = original_clock_speed;
+        HAL_I2C_Init(i2c_handle);
+    }
+
+    /**
+     * @brief Dumps the whole EEPROM twice, once with a two-byte read per word and once with
+     * sequential range reads, and logs the throughput of each path. A checksum over the data
+     * confirms that both paths read the same contents.
+     * @param eeprom Pointer to the EEPROM to read from.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runEEPROMReadBenchmark(EEPROM *eeprom, UART_HandleTypeDef *uart_handle)
+    {
+        static uint8_t read_buffer[READ_BUFFER_SIZE];
+        HAL_StatusTypeDef status = HAL_OK;
+        uint32_t word_checksum = 0;
+        uint32_t range_checksum = 0;
+
+        // Per-word path: one address transmit and one two-byte receive per word
+        uint32_t start_ms = HAL_GetTick();
+
+        for (uint32_t address = EEPROM_MIN_ADDRESS; address <= EEPROM_MAX_ADDRESS && status == HAL_OK; address += 2)
+        {
+            uint16_t data;
+            status = eeprom->readTwoBytes(address, &data);
+
+            if (status == HAL_OK)
+            {
+                word_checksum += (data >> 8) + (data & 0xFF);
+            }
+        }
+
+        uint32_t word_elapsed_ms = HAL_GetTick() - start_ms;
+
+        if (status != HAL_OK)
+        {
+            logFormattedMessage(uart_handle, "Error: Per-word EEPROM read benchmark failed!\r\n");
+            return;
+        }
+
+        // Sequential path: one address transmit per buffer, streamed into the caller buffer
+        start_ms = HAL_GetTick();
+
+        for (uint32_t address = EEPROM_MIN_ADDRESS; address <= EEPROM_MAX_ADDRESS && status == HAL_OK; address += READ_BUFFER_SIZE)
+        {
+            status = eeprom->readRange(address, read_buffer, READ_BUFFER_SIZE);
+
+            for (uint16_t i = 0; i < READ_BUFFER_SIZE; i++)
+            {
+                range_checksum += read_buffer[i];
+            }
+        }
+
+        uint32_t range_elapsed_ms = HAL_GetTick() - start_ms;
+
+        if (status != HAL_OK)
+        {
+            logFormattedMessage(uart_handle, "Error: Range EEPROM read benchmark failed!\r\n");
+            return;
+        }
+
+        logFormattedMessage(uart_handle, "Per-word read: %lu B in %lu ms (%lu B/s).\r\n",
+                            static_cast<unsigned long>(EEPROM_SIZE), static_cast<unsigned long>(word_elapsed_ms),
+                            static_cast<unsigned long>(calculateBytesPerSecond(EEPROM_SIZE, word_elapsed_ms)));
+
+        logFormattedMessage(uart_handle, "Range read: %lu B in %lu ms (%lu B/s).\r\n",
+                            static_cast<unsigned long>(EEPROM_SIZE), static_cast<unsigned long>(range_elapsed_ms),
+                            static_cast<unsigned long>(calculateBytesPerSecond(EEPROM_SIZE, range_elapsed_ms)));
+
+        logFormattedMessage(uart_handle, "Checksums %s (0x%08lX).\r\n",
+                            word_checksum == range_checksum ? "match" : "DIFFER",
+                            static_cast<unsigned long>(range_checksum));
+    }
+
+    /**
+     * @brief Reads every record of the log and measures the time spent decoding the samples, to
+     * confirm that a full-chip dump can be unpacked faster than the UART can send it. Requires the
+     * cycle counter to be enabled.
+     * @param eeprom_log Pointer to the EEPROM log to decode.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runLogDecodeBenchmark(EEPROMLog *eeprom_log, UART_HandleTypeDef *uart_handle)
+    {
+        DecodeBenchmarkContext context = {eeprom_log, 0, 0};
+        LogScanResult result;
+
+        HAL_StatusTypeDef status = eeprom_log->scanRecords(decodeRecordSamples, &context, &result);
+
+        if (status != HAL_OK)
+        {
+            logFormattedMessage(uart_handle, "Error: Log decode benchmark failed!\r\n");
+            return;
+        }
+
+        uint32_t decode_us = utility::convertCyclesToMicroseconds(context.decode_cycles);
+        uint32_t samples_per_second = static_cast<uint32_t>((static_cast<uint64_t>(context.sample_count) * 1000000) /
+                                                            (decode_us == 0 ? 1 : decode_us));
+
+        logFormattedMessage(uart_handle, "Decoded %lu samples of %u records in %lu us.\r\n",
+                            static_cast<unsigned long>(context.sample_count), result.valid_record_count,
+                            static_cast<unsigned long>(decode_us));
+
+        logFormattedMessage(uart_handle, "Decode: %lu samples/s (UART: %lu).\r\n",
+                            static_cast<unsigned long>(samples_per_second),
+                            static_cast<unsigned long>(UART_DUMP_SAMPLES_PER_SECOND));
+    }
+
+    /**
+     * @brief Re-encodes the samples recorded in the log with the delta codec and logs the
+     * compression ratio against raw and packed storage, the resulting chip capacity, and the encode
+     * cycles per sample. Requires the cycle counter to be enabled.
+     * @param eeprom_log Pointer to the EEPROM log holding the recorded trace.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runDeltaCodecBenchmark(EEPROMLog *eeprom_log, UART_HandleTypeDef *uart_handle)
+    {
+        static DeltaBenchmarkContext context;
+        LogScanResult result;
+
+        context = {};
+        context.eeprom_log = eeprom_log;
+        context.bit_width = 9 + (eeprom_log->getSampleFormat() & LOG_FORMAT_RESOLUTION_MASK);
+
+        HAL_StatusTypeDef status = eeprom_log->scanRecords(encodeRecordSamples, &context, &result);
+
+        if (status != HAL_OK || context.record_count == 0)
+        {
+            logFormattedMessage(uart_handle, "Error: Delta codec benchmark failed!\r\n");
+            return;
+        }
+
+        // Ratios in hundredths: payload bits of the trace when stored raw or packed, over the delta payload bits
+        uint32_t delta_bits = context.record_count * LOG_RECORD_PAYLOAD_SIZE * 8;
+        uint32_t raw_ratio = context.sample_count * 16 * 100 / delta_bits;
+        uint32_t packed_ratio = context.sample_count * context.bit_width * 100 / delta_bits;
+        uint32_t capacity = context.sample_count * eeprom_log->getRecordCount() / context.record_count;
+
+        logFormattedMessage(uart_handle, "Delta: %lu samples in %lu records, %lu per log.\r\n",
+                            static_cast<unsigned long>(context.sample_count), static_cast<unsigned long>(context.record_count),
+                            static_cast<unsigned long>(capacity));
+
+        logFormattedMessage(uart_handle, "Delta ratio: %lu.%02lux raw, %lu.%02lux packed.\r\n",
+                            static_cast<unsigned long>(raw_ratio / 100), static_cast<unsigned long>(raw_ratio % 100),
+                            static_cast<unsigned long>(packed_ratio / 100), static_cast<unsigned long>(packed_ratio % 100));
+
+        logFormattedMessage(uart_handle, "Delta encode: %lu cycles/sample.\r\n",
+                            static_cast<unsigned long>(context.encode_cycles / context.sample_count));
+    }
+
+    /**
+     * @brief Converts and formats every temperature the TMP100 can report at its current resolution,
+     * once with the float conversion and "%.02f", and once with the centi-degree conversion and
+     * integer formatting. Logs the cycles per temperature of both paths and the number of values
+     * whose text differs. Requires the cycle counter to be enabled; the float path links the
+     * floating-point printf support, so the benchmark is only built into images that run it.
+     * @param temperature_sensor Pointer to the TMP100 whose resolution and conversions are used.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runTemperatureFormatBenchmark(TMP100 *temperature_sensor, UART_HandleTypeDef *uart_handle)
+    {
+        char float_text[16];
+        char fixed_text[16];
+        uint32_t float_cycles = 0;
+        uint32_t fixed_cycles = 0;
+        uint32_t value_count = 0;
+        uint32_t mismatch_count = 0;
+        int32_t step = 1 << (7 - temperature_sensor->getResolutionBits());
+
+        for (int32_t q8_8_temperature = TMP100_MIN_Q8_8; q8_8_temperature <= TMP100_MAX_Q8_8; q8_8_temperature += step)
+        {
+            uint16_t raw_temperature_data = static_cast<uint16_t>(q8_8_temperature);
+
+            uint32_t start_cycles = utility::getCycleCount();
+            float celsius_temperature_data = temperature_sensor->convertRawTemperatureDataToCelsius(raw_temperature_data);
+            snprintf(float_text, sizeof(float_text), "%.02f", celsius_temperature_data);
+            float_cycles += utility::getCycleCount() - start_cycles;
+
+            start_cycles = utility::getCycleCount();
+            int16_t centi_celsius_temperature_data = temperature_sensor->convertRawTemperatureDataToCentiCelsius(raw_temperature_data);
+            utility::formatFixedPoint(fixed_text, sizeof(fixed_text), centi_celsius_temperature_data, 2);
+            fixed_cycles += utility::getCycleCount() - start_cycles;
+
+            if (strcmp(float_text, fixed_text) != 0)
+            {
+                mismatch_count++;
+            }
+
+            value_count++;
+        }
+
+        logFormattedMessage(uart_handle, "Format: float %lu, fixed %lu cycles/value.\r\n",
+                            static_cast<unsigned long>(float_cycles / value_count), static_cast<unsigned long>(fixed_cycles / value_count));
+
+        logFormattedMessage(uart_handle, "Format: %lu of %lu values differ.\r\n",
+                            static_cast<unsigned long>(mismatch_count), static_cast<unsigned long>(value_count));
+    }
+
+    /**
+     * @brief Measures the cycles per sample of each filter type at a short and a long window and
+     * logs them together with the peak-to-peak output for a noisy input with spikes. Requires the
+     * cycle counter to be enabled.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runFilterBenchmark(UART_HandleTypeDef *uart_handle)
+    {
+        char peak_to_peak_text[16];
+
+        for (size_t type_index = 0; type_index < sizeof(FILTER_BENCHMARK_TYPES) / sizeof(FILTER_BENCHMARK_TYPES[0]); type_index++)
+        {
+            for (uint8_t length : FILTER_BENCHMARK_LENGTHS)
+            {
+                // Without a filter the length has no effect, a single pass gives the input for comparison
+                if (FILTER_BENCHMARK_TYPES[type_index] == FilterType::None && length != FILTER_BENCHMARK_LENGTHS[0])
+                {
+                    continue;
+                }
+
+                TemperatureFilter filter = TemperatureFilter(FILTER_BENCHMARK_TYPES[type_index], length);
+                uint32_t noise_state = 1;
+                uint32_t filter_cycles = 0;
+                int16_t min_output = INT16_MAX;
+                int16_t max_output = INT16_MIN;
+
+                for (uint32_t i = 0; i < FILTER_BENCHMARK_SAMPLE_COUNT; i++)
+                {
+                    // Linear congruential generator, so every filter sees the same input
+                    noise_state = noise_state * 1103515245 + 12345;
+                    int16_t noise = static_cast<int16_t>((noise_state >> 16) % (2 * FILTER_BENCHMARK_NOISE_LSB + 1)) - FILTER_BENCHMARK_NOISE_LSB;
+                    int16_t spike = (i % FILTER_BENCHMARK_SPIKE_INTERVAL == FILTER_BENCHMARK_SPIKE_INTERVAL - 1) ? FILTER_BENCHMARK_SPIKE_Q8_8 : 0;
+                    int16_t sample = FILTER_BENCHMARK_BASE_Q8_8 + noise * FILTER_BENCHMARK_LSB_Q8_8 + spike;
+
+                    uint32_t start_cycles = utility::getCycleCount();
+                    int16_t output = filter.update(sample);
+                    filter_cycles += utility::getCycleCount() - start_cycles;
+
+                    if (i < FILTER_MAX_LENGTH)
+                    {
+                        continue;
+                    }
+
+                    min_output = (output < min_output) ? output : min_output;
+                    max_output = (output > max_output) ? output : max_output;
+                }
+
+                utility::formatFixedPoint(peak_to_peak_text, sizeof(peak_to_peak_text),
+                                          utility::convertQ8_8ToCentiCelsius(max_output - min_output), 2);
+                logFormattedMessage(uart_handle, "Filter %s/%u: %lu cycles/sample, p-p %sC.\r\n",
+                                    FILTER_BENCHMARK_NAMES[type_index], filter.getLength(),
+                                    static_cast<unsigned long>(filter_cycles / FILTER_BENCHMARK_SAMPLE_COUNT), peak_to_peak_text);
+            }
+        }
+    }
+
+    /**
+     * @brief Measures how long a 50-byte status line blocks the caller, once sent with a blocking
+     * HAL_UART_Transmit and once logged through the DMA ring buffer of the UARTLogger, and logs the
+     * average time per line. Then compares the cycles per formatted line of snprintf into a stack
+     * buffer followed by logStatusMessage with logFormattedMessage, which formats in place. Requires a
+     * registered UARTLogger and the cycle counter to be enabled.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runUARTLogBenchmark(UART_HandleTypeDef *uart_handle)
+    {
+        char line[] = "UART log benchmark line, 50 bytes long..........\r\n";
+        UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+        if (uart_logger == nullptr)
+        {
+            logFormattedMessage(uart_handle, "UART log: no DMA logger registered.\r\n");
+            return;
+        }
+
+        // Start both measurements with an idle UART and an empty ring buffer
+        uart_logger->flush(UART_BENCHMARK_FLUSH_TIMEOUT_MS);
+
+        uint32_t start_cycles = utility::getCycleCount();
+        for (uint32_t i = 0; i < UART_BENCHMARK_LINE_COUNT; i++)
+        {
+            HAL_UART_Transmit(uart_handle, reinterpret_cast<uint8_t *>(line), strlen(line), HAL_MAX_DELAY);
+        }
+        uint32_t blocking_us = utility::convertCyclesToMicroseconds(utility::getCycleCount() - start_cycles);
+
+        start_cycles = utility::getCycleCount();
+        for (uint32_t i = 0; i < UART_BENCHMARK_LINE_COUNT; i++)
+        {
+            logStatusMessage(uart_handle, line);
+        }
+        uint32_t buffered_us = utility::convertCyclesToMicroseconds(utility::getCycleCount() - start_cycles);
+
+        uart_logger->flush(UART_BENCHMARK_FLUSH_TIMEOUT_MS);
+
+        start_cycles = utility::getCycleCount();
+        for (uint32_t i = 0; i < UART_BENCHMARK_LINE_COUNT; i++)
+        {
+            char status_message[64];
+            snprintf(status_message, sizeof(status_message), "Sample %lu: 0x%04X at 0x%04lX.\r\n",
+                     static_cast<unsigned long>(i), 0x1A40U, static_cast<unsigned long>(i * 64));
+            logStatusMessage(uart_handle, status_message);
+        }
+        uint32_t copied_cycles = utility::getCycleCount() - start_cycles;
+
+        uart_logger->flush(UART_BENCHMARK_FLUSH_TIMEOUT_MS);
+
+        start_cycles = utility::getCycleCount();
+        for (uint32_t i = 0; i < UART_BENCHMARK_LINE_COUNT; i++)
+        {
+            logFormattedMessage(uart_handle, "Sample %lu: 0x%04X at 0x%04lX.\r\n",
+                                static_cast<unsigned long>(i), 0x1A40U, static_cast<unsigned long>(i * 64));
+        }
+        uint32_t in_place_cycles = utility::getCycleCount() - start_cycles;
+
+        uart_logger->flush(UART_BENCHMARK_FLUSH_TIMEOUT_MS);
+
+        logFormattedMessage(uart_handle, "UART log: blocking %lu us, DMA %lu us per line.\r\n",
+                            static_cast<unsigned long>(blocking_us / UART_BENCHMARK_LINE_COUNT),
+                            static_cast<unsigned long>(buffered_us / UART_BENCHMARK_LINE_COUNT));
+        logFormattedMessage(uart_handle, "UART format: copied %lu, in place %lu cycles per line.\r\n",
+                            static_cast<unsigned long>(copied_cycles / UART_BENCHMARK_LINE_COUNT),
+                            static_cast<unsigned long>(in_place_cycles / UART_BENCHMARK_LINE_COUNT));
+    }
+
+    /**
+     * @brief Measures the cycles and UART bytes per "Current Temperature" message of three paths:
+     * the previous fixed-point text formatting with snprintf, the expansion of the token table
+     * format string on the device (text encoding), and the log frame of the tokenized encoding, and
+     * the cycles of a message disabled by the runtime log level mask. Nothing is sent during the
+     * measurement. Requires the cycle counter to be enabled.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     */
+    void runTokenLogBenchmark(UART_HandleTypeDef *uart_handle)
+    {
+        if constexpr (!tokenlog::isTokenCompiled(LogToken::CurrentTemperature))
+        {
+            logFormattedMessage(uart_handle, "Token log: message removed by the compile-time log filter.\r\n");
+            return;
+        }
+
+        const char *format = LOG_TOKEN_FORMATS[static_cast<uint8_t>(LogToken::CurrentTemperature)];
+        char message[64];
+        uint8_t frame[LOG_MAX_FRAME_SIZE];
+        uint32_t snprintf_cycles = 0;
+        uint32_t snprintf_bytes = 0;
+        uint32_t expand_cycles = 0;
+        uint32_t expand_bytes = 0;
+        uint32_t frame_cycles = 0;
+        uint32_t frame_bytes = 0;
+
+        for (uint32_t i = 0; i < TOKEN_BENCHMARK_MESSAGE_COUNT; i++)
+        {
+            int16_t q8_8_temperature = TOKEN_BENCHMARK_BASE_Q8_8 + i * 16;
+
+            uint32_t start_cycles = utility::getCycleCount();
+            char temperature_text[8];
+            utility::formatFixedPoint(temperature_text, sizeof(temperature_text), utility::convertQ8_8ToCentiCelsius(q8_8_temperature), 2);
+            snprintf_bytes += snprintf(message, sizeof(message), "Current Temperature 0x%02X: %s°C.\r\n", 0x48, temperature_text);
+            snprintf_cycles += utility::getCycleCount() - start_cycles;
+
+            start_cycles = utility::getCycleCount();
+            int32_t arguments[] = {0x48, utility::convertQ8_8ToCentiCelsius(q8_8_temperature)};
+            expand_bytes += tokenlog::expandMessage(message, sizeof(message), format, arguments, 2);
+            expand_cycles += utility::getCycleCount() - start_cycles;
+
+            start_cycles = utility::getCycleCount();
+            arguments[1] = utility::convertQ8_8ToCentiCelsius(q8_8_temperature);
+            frame_bytes += tokenlog::encodeFrame(frame, LogToken::CurrentTemperature, arguments, 2);
+            frame_cycles += utility::getCycleCount() - start_cycles;
+        }
+
+        // A message disabled at runtime returns before its arguments are formatted or encoded
+        uint8_t level_mask = utility::getLogLevelMask();
+        utility::setLogLevelMask(0);
+        uint32_t start_cycles = utility::getCycleCount();
+        for (uint32_t i = 0; i < TOKEN_BENCHMARK_MESSAGE_COUNT; i++)
+        {
+            int16_t q8_8_temperature = TOKEN_BENCHMARK_BASE_Q8_8 + i * 16;
+            utility::logToken<LogToken::CurrentTemperature>(uart_handle, 0x48, utility::convertQ8_8ToCentiCelsius(q8_8_temperature));
+        }
+        uint32_t filtered_cycles = utility::getCycleCount() - start_cycles;
+        utility::setLogLevelMask(level_mask);
+
+        logFormattedMessage(uart_handle, "Token log: snprintf %lu cyc %lu B, expand %lu cyc %lu B, frame %lu cyc %lu B.\r\n",
+                            static_cast<unsigned long>(snprintf_cycles / TOKEN_BENCHMARK_MESSAGE_COUNT),
+                            static_cast<unsigned long>(snprintf_bytes / TOKEN_BENCHMARK_MESSAGE_COUNT),
+                            static_cast<unsigned long>(expand_cycles / TOKEN_BENCHMARK_MESSAGE_COUNT),
+                            static_cast<unsigned long>(expand_bytes / TOKEN_BENCHMARK_MESSAGE_COUNT),
+                            static_cast<unsigned long>(frame_cycles / TOKEN_BENCHMARK_MESSAGE_COUNT),
+                            static_cast<unsigned long>(frame_bytes / TOKEN_BENCHMARK_MESSAGE_COUNT));
+        logFormattedMessage(uart_handle, "Token log: filtered at runtime %lu cyc.\r\n",
+                            static_cast<unsigned long>(filtered_cycles / TOKEN_BENCHMARK_MESSAGE_COUNT));
+    }
+}
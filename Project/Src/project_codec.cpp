@@ -0,0 +1,352 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_codec.cpp
+ * @brief Implementation file for the sample storage codecs.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "project_codec.h"
+
+// Width of a delta stream code
+constexpr uint8_t DELTA_CODE_BITS = 4;
+
+// CRC-16/CCITT lookup table, one entry per nibble (polynomial 0x1021)
+constexpr uint16_t CRC16_NIBBLE_TABLE[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+namespace
+{
+    /**
+     * @brief Sign-extends a two's complement bit field to 16 bits.
+     * @param value The bit field.
+     * @param bit_width The width of the bit field in bits (1 to 16).
+     * @return The signed value.
+     */
+    int16_t signExtend(uint16_t value, uint8_t bit_width)
+    {
+        return static_cast<int16_t>(value << (16 - bit_width)) >> (16 - bit_width);
+    }
+
+    /**
+     * @brief Records a value of a delta stream as the prediction for the next value of its channel
+     * and advances to the next channel.
+     * @param value The value appended to or decoded from the stream.
+     * @param state Pointer to the stream state.
+     */
+    void advanceChannel(uint16_t value, DeltaStreamState *state)
+    {
+        state->channel_values[state->channel_index] = value;
+        state->previous_value = value;
+
+        if (++state->channel_index == state->channel_count)
+        {
+            state->channel_index = 0;
+        }
+    }
+
+    /**
+     * @brief Initializes the state of a delta stream from its keyframe.
+     * @param value The keyframe, the first value of the stream and the initial prediction of every channel.
+     * @param bit_width The width of the values in bits (1 to 16).
+     * @param channel_count The number of interleaved channels (1 to DELTA_MAX_CHANNELS).
+     * @param state Pointer to the stream state to initialize.
+     */
+    void initializeStream(uint16_t value, uint8_t bit_width, uint8_t channel_count, DeltaStreamState *state)
+    {
+        *state = {};
+        state->bit_offset = bit_width;
+        state->channel_count = (channel_count > 0 && channel_count <= DELTA_MAX_CHANNELS) ? channel_count : 1;
+
+        for (uint8_t i = 0; i < state->channel_count; i++)
+        {
+            state->channel_values[i] = value;
+        }
+
+        advanceChannel(value, state);
+    }
+}
+
+namespace codec
+{
+    /**
+     * @brief Writes a value into a bit field of a buffer, most significant bit first. Fields may
+     * cross byte boundaries; bits outside the field are left unchanged.
+     * @param buffer Pointer to the buffer to write to.
+     * @param bit_offset The offset of the first bit of the field from the start of the buffer.
+     * @param value The value to write. Only its lowest bit_width bits are stored.
+     * @param bit_width The width of the field in bits (1 to 16).
+     */
+    void packBits(uint8_t *buffer, uint32_t bit_offset, uint16_t value, uint8_t bit_width)
+    {
+        uint8_t *byte = &buffer[bit_offset / 8];
+        uint8_t free_bits = 8 - (bit_offset % 8);
+        uint8_t remaining_bits = bit_width;
+
+        while (remaining_bits > 0)
+        {
+            uint8_t chunk_bits = remaining_bits < free_bits ? remaining_bits : free_bits;
+            uint8_t shift = free_bits - chunk_bits;
+            uint8_t mask = ((1u << chunk_bits) - 1) << shift;
+            uint8_t bits = (value >> (remaining_bits - chunk_bits)) << shift;
+
+            *byte = (*byte & ~mask) | (bits & mask);
+
+            remaining_bits -= chunk_bits;
+            free_bits = 8;
+            byte++;
+        }
+    }
+
+    /**
+     * @brief Reads a value from a bit field of a buffer, most significant bit first.
+     * @param buffer Pointer to the buffer to read from.
+     * @param bit_offset The offset of the first bit of the field from the start of the buffer.
+     * @param bit_width The width of the field in bits (1 to 16).
+     * @return The value of the field.
+     */
+    uint16_t unpackBits(const uint8_t *buffer, uint32_t bit_offset, uint8_t bit_width)
+    {
+        const uint8_t *byte = &buffer[bit_offset / 8];
+        uint32_t accumulator = *byte++;
+        uint8_t accumulated_bits = 8 - (bit_offset % 8);
+
+        while (accumulated_bits < bit_width)
+        {
+            accumulator = (accumulator << 8) | *byte++;
+            accumulated_bits += 8;
+        }
+
+        return (accumulator >> (accumulated_bits - bit_width)) & ((1u << bit_width) - 1);
+    }
+
+    /**
+     * @brief Unpacks consecutive bit fields starting at the beginning of a buffer. Each byte is
+     * loaded once into a bit accumulator, so a full record decodes in a few cycles per sample.
+     * @param buffer Pointer to the packed fields.
+     * @param sample_count The number of fields to unpack.
+     * @param bit_width The width of each field in bits (1 to 16).
+     * @param samples Pointer to an array of sample_count values where the fields will be stored.
+     */
+    void unpackSamples(const uint8_t *buffer, uint16_t sample_count, uint8_t bit_width, uint16_t *samples)
+    {
+        uint32_t accumulator = 0;
+        uint8_t accumulated_bits = 0;
+        uint32_t mask = (1u << bit_width) - 1;
+
+        for (uint16_t i = 0; i < sample_count; i++)
+        {
+            while (accumulated_bits < bit_width)
+            {
+                accumulator = (accumulator << 8) | *buffer++;
+                accumulated_bits += 8;
+            }
+
+            accumulated_bits -= bit_width;
+            samples[i] = (accumulator >> accumulated_bits) & mask;
+        }
+    }
+
+    /**
+     * @brief Starts a delta stream by writing the keyframe at the beginning of a buffer.
+     * @param buffer Pointer to the buffer holding the stream.
+     * @param value The first value, a two's complement bit field of bit_width bits.
+     * @param bit_width The width of the values in bits (1 to 16).
+     * @param channel_count The number of interleaved channels (1 to DELTA_MAX_CHANNELS), the first
+     * value belonging to channel 0.
+     * @param state Pointer to the encoder state to initialize.
+     */
+    void startDeltaStream(uint8_t *buffer, uint16_t value, uint8_t bit_width, uint8_t channel_count, DeltaStreamState *state)
+    {
+        packBits(buffer, 0, value, bit_width);
+        initializeStream(value, bit_width, channel_count, state);
+    }
+
+    /**
+     * @brief Appends a value to a delta stream. Unchanged values extend the open run in place, so a
+     * stable signal costs about half a bit per sample.
+     * @param buffer Pointer to the buffer holding the stream.
+     * @param capacity_bits The size of the buffer in bits.
+     * @param value The value to append, a two's complement bit field of bit_width bits.
+     * @param bit_width The width of the values in bits (1 to 16).
+     * @param state Pointer to the encoder state of the stream.
+     * @return True if the value was appended, false if the buffer is full.
+     */
+    bool appendDeltaSample(uint8_t *buffer, uint16_t capacity_bits, uint16_t value, uint8_t bit_width, DeltaStreamState *state)
+    {
+        uint16_t predicted_value = state->channel_values[state->channel_index];
+        int16_t delta = signExtend(value, bit_width) - signExtend(predicted_value, bit_width);
+        uint16_t zigzag = static_cast<uint16_t>((static_cast<uint16_t>(delta) << 1) ^ (delta >> 15));
+
+        if (zigzag == 0 && state->run_length > 0 && state->run_length < DELTA_MAX_RUN_LENGTH)
+        {
+            // Extend the open run
+            state->run_length++;
+            packBits(buffer, state->run_offset + DELTA_CODE_BITS, state->run_length - DELTA_MIN_RUN_LENGTH, DELTA_CODE_BITS);
+            advanceChannel(value, state);
+            return true;
+        }
+
+        if (zigzag == 0 && state->zero_count == DELTA_MIN_RUN_LENGTH - 1)
+        {
+            // Replace the two preceding zero codes with a run of three, which takes the same space
+            state->run_offset = state->bit_offset - 2 * DELTA_CODE_BITS;
+            state->run_length = DELTA_MIN_RUN_LENGTH;
+            state->zero_count = 0;
+            packBits(buffer, state->run_offset, DELTA_RUN_CODE, DELTA_CODE_BITS);
+            packBits(buffer, state->run_offset + DELTA_CODE_BITS, 0, DELTA_CODE_BITS);
+            advanceChannel(value, state);
+            return true;
+        }
+
+        if (zigzag <= DELTA_MAX_ZIGZAG_CODE)
+        {
+            if (state->bit_offset + DELTA_CODE_BITS > capacity_bits)
+            {
+                return false;
+            }
+
+            packBits(buffer, state->bit_offset, zigzag, DELTA_CODE_BITS);
+            state->bit_offset += DELTA_CODE_BITS;
+            state->zero_count = zigzag == 0 ? state->zero_count + 1 : 0;
+        }
+        else
+        {
+            if (state->bit_offset + DELTA_CODE_BITS + bit_width > capacity_bits)
+            {
+                return false;
+            }
+
+            packBits(buffer, state->bit_offset, DELTA_ESCAPE_CODE, DELTA_CODE_BITS);
+            packBits(buffer, state->bit_offset + DELTA_CODE_BITS, value, bit_width);
+            state->bit_offset += DELTA_CODE_BITS + bit_width;
+            state->zero_count = 0;
+        }
+
+        state->run_length = 0;
+        advanceChannel(value, state);
+
+        return true;
+    }
+
+    /**
+     * @brief Decodes the values of a delta stream. Decoding stops early if the stream ends before
+     * sample_count values, which only happens for a corrupt stream.
+     * @param buffer Pointer to the buffer holding the stream.
+     * @param capacity_bits The size of the buffer in bits.
+     * @param sample_count The number of values in the stream.
+     * @param bit_width The width of the values in bits (1 to 16).
+     * @param channel_count The number of interleaved channels the stream was started with.
+     * @param samples Pointer to an array of sample_count values where the values will be stored, or
+     * nullptr to only walk the stream.
+     * @param state Pointer to a DeltaStreamState where the encoder state at the end of the stream
+     * will be stored (to resume appending), or nullptr.
+     * @return The number of values decoded.
+     */
+    uint16_t decodeDeltaStream(const uint8_t *buffer, uint16_t capacity_bits, uint16_t sample_count, uint8_t bit_width,
+                               uint8_t channel_count, uint16_t *samples, DeltaStreamState *state)
+    {
+        DeltaStreamState stream = {};
+        uint16_t decoded_count = 0;
+
+        if (sample_count > 0 && bit_width <= capacity_bits)
+        {
+            initializeStream(unpackBits(buffer, 0, bit_width), bit_width, channel_count, &stream);
+
+            if (samples != nullptr)
+            {
+                samples[decoded_count] = stream.previous_value;
+            }
+
+            decoded_count++;
+        }
+
+        uint16_t mask = (1u << bit_width) - 1;
+
+        while (decoded_count < sample_count && stream.bit_offset + DELTA_CODE_BITS <= capacity_bits)
+        {
+            uint16_t code_offset = stream.bit_offset;
+            uint8_t code = unpackBits(buffer, code_offset, DELTA_CODE_BITS);
+            uint8_t repeat_count = 1;
+            uint16_t value = stream.channel_values[stream.channel_index];
+
+            stream.bit_offset += DELTA_CODE_BITS;
+
+            if (code <= DELTA_MAX_ZIGZAG_CODE)
+            {
+                int16_t delta = (code >> 1) ^ -(code & 1);
+                value = (value + delta) & mask;
+                stream.zero_count = code == 0 ? stream.zero_count + 1 : 0;
+                stream.run_length = 0;
+            }
+            else if (code == DELTA_RUN_CODE)
+            {
+                if (stream.bit_offset + DELTA_CODE_BITS > capacity_bits)
+                {
+                    break;
+                }
+
+                repeat_count = DELTA_MIN_RUN_LENGTH + unpackBits(buffer, stream.bit_offset, DELTA_CODE_BITS);
+                stream.bit_offset += DELTA_CODE_BITS;
+                stream.run_offset = code_offset;
+                stream.run_length = repeat_count;
+                stream.zero_count = 0;
+            }
+            else
+            {
+                if (stream.bit_offset + bit_width > capacity_bits)
+                {
+                    break;
+                }
+
+                value = unpackBits(buffer, stream.bit_offset, bit_width);
+                stream.bit_offset += bit_width;
+                stream.zero_count = 0;
+                stream.run_length = 0;
+            }
+
+            // Each value of a run repeats the previous value of its own channel
+            for (uint8_t i = 0; i < repeat_count && decoded_count < sample_count; i++)
+            {
+                if (i > 0)
+                {
+                    value = stream.channel_values[stream.channel_index];
+                }
+
+                if (samples != nullptr)
+                {
+                    samples[decoded_count] = value;
+                }
+
+                advanceChannel(value, &stream);
+                decoded_count++;
+            }
+        }
+
+        if (state != nullptr)
+        {
+            *state = stream;
+        }
+
+        return decoded_count;
+    }
+
+    /**
+     * @brief Calculates the CRC-16/CCITT (polynomial 0x1021, no reflection) of a block of data using
+     * a 16-entry nibble table. With the default initial value this is CRC-16/CCITT-FALSE.
+     * @param data Pointer to the data.
+     * @param length The number of bytes.
+     * @param crc The initial value, or the result of a previous call to continue a calculation.
+     * @return The 16-bit CRC.
+     */
+    uint16_t calculateCRC16(const uint8_t *data, size_t length, uint16_t crc)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            crc = (crc << 4) ^ CRC16_NIBBLE_TABLE[(crc >> 12) ^ (data[i] >> 4)];
+            crc = (crc << 4) ^ CRC16_NIBBLE_TABLE[(crc >> 12) ^ (data[i] & 0x0F)];
+        }
+
+        return crc;
+    }
+}
@@ -5,109 +5,808 @@
  * ------------------------------------------------------------------------------------------------
  */
 
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "project_main.h"
 #include "tmp100.h"
+#include "TMP100Array.h"
+#include "TMP100ResolutionScheduler.h"
+#include "TMP100Burst.h"
+#include "TemperatureFilter.h"
 #include "eeprom.h"
+#include "EEPROMArray.h"
+#include "EEPROMLog.h"
+#include "EEPROMAsync.h"
+#include "UARTLogger.h"
 #include "project_utility.h"
+#include "project_benchmark.h"
 
 // Delay timing
 constexpr uint32_t DELAY_MS = 1000;
 
-using utility::logStatusMessage;
+// Number of samples between flushes of the current EEPROM log record (bounds the samples lost on power loss)
+constexpr uint32_t LOG_FLUSH_INTERVAL = 10;
+
+// Number of samples between EEPROM write cycle statistics reports
+constexpr uint32_t WRITE_CYCLE_REPORT_INTERVAL = 64;
+
+// Commit log records via DMA in the background instead of blocking the main loop for each page write
+constexpr bool USE_ASYNC_EEPROM_WRITES = true;
+
+// Storage encoding of new samples: LOG_FORMAT_RAW16, LOG_FORMAT_PACKED (only the significant bits at the
+// TMP100 resolution), or LOG_FORMAT_DELTA (delta stream, about 4x the samples of PACKED for room temperature)
+constexpr uint8_t LOG_SAMPLE_ENCODING = LOG_FORMAT_DELTA;
+
+// Background verification of the written log records: Off, PerPage (read back each committed page once), or
+// PeriodicScrub (check one stored record per sample, cycling through the log)
+constexpr LogVerifyPolicy LOG_VERIFY_POLICY = LogVerifyPolicy::PerPage;
+
+// Detection of completed TMP100 conversions: FixedDelay (wait the full conversion time, 2 transactions per
+// sample) or Adaptive (poll the OS/ALERT bit every TMP100_POLL_INTERVAL_MS, starting shortly before the learned
+// conversion time; rewrites T_HIGH and T_LOW before every conversion, about 6 transactions per sample)
+constexpr TMP100WaitMode TMP100_WAIT_MODE = TMP100WaitMode::FixedDelay;
+constexpr uint32_t TMP100_POLL_INTERVAL_MS = 2;
+
+// Event logging: samples within LOG_EVENT_BAND (raw register units, 1/256C per LSB) of the last logged scan are
+// stored as a repeat of it and neither flushed nor reported; the log is flushed once a sensor leaves the band, and
+// at least every LOG_EVENT_MAX_HOLD samples. When false, every sample is stored as read and flushed periodically
+constexpr bool LOG_EVENT_MODE = false;
+constexpr int16_t LOG_EVENT_BAND = 0x0080;
+constexpr uint32_t LOG_EVENT_MAX_HOLD = 60;
+
+// Resolution scheduling: choose the TMP100 resolution once per window of samples between 9 bits (flat or fast-changing
+// temperature) and 12 bits (on a slow trend, or within 1C of the 5C and 30C alarm thresholds, which applies at once).
+// Each change closes the log record. When false, the resolution stays at the 10 bits configured by 0x21
+constexpr bool USE_RESOLUTION_SCHEDULER = false;
+constexpr TMP100ResolutionPolicy RESOLUTION_POLICY = {
+	0b00,	  // Minimum resolution (9-bit)
+	0b11,	  // Maximum resolution (12-bit)
+	0x0500,	  // Low alarm threshold (5C)
+	0x1E00,	  // High alarm threshold (30C)
+	0x0100,	  // Alarm margin (1C)
+	0x0040,	  // Slow trend from a net change of 0.25C per window
+	0x0080,	  // Fast from 0.5C per sample
+	DELAY_MS, // Conversion budget (the sample period)
+	64		  // Window (samples)
+};
+
+// Filtering between acquisition and storage: FilterType::None, MovingAverage, Median (spike rejection), or EWMA over
+// FILTER_LENGTH samples of each sensor, in Q8.8 fixed point. Each stored sample is the filter output after
+// OVERSAMPLING_COUNT conversions, so a moving average of as many samples averages each block of conversions. Filtered
+// samples keep fraction bits below the conversion resolution and are stored at FILTER_RESOLUTION_BITS (12-bit at most,
+// the finest resolution of the log format)
+constexpr FilterType FILTER_TYPE = FilterType::None;
+constexpr uint8_t FILTER_LENGTH = 4;
+constexpr uint8_t OVERSAMPLING_COUNT = 1;
+constexpr uint8_t FILTER_RESOLUTION_BITS = 0b11;
+
+// Burst acquisition for thermal-transient tests: before logging starts, the first TMP100 is sampled in continuous-conversion
+// mode for BURST_WINDOW_MS at each resolution selected in BURST_RESOLUTION_MASK (bit n for R1R0 = n), with a read every
+// BURST_PERIOD_MS (0 for the conversion time: 25 Hz at 9-bit to about 3 Hz at 12-bit). The readings are buffered in RAM,
+// streamed out via UART after each burst, and followed by the achieved sample rate and jitter
+constexpr bool BURST_MODE = false;
+constexpr uint8_t BURST_RESOLUTION_MASK = 0b1111;
+constexpr uint32_t BURST_WINDOW_MS = 10000;
+constexpr uint32_t BURST_PERIOD_MS = 0;
+
+// Maximum time to wait for a background EEPROM transfer to release the I2C bus (a 66-byte page takes about 6 ms at 100 kHz)
+constexpr uint32_t I2C_BUS_TIMEOUT_MS = 10;
+
+// Send UART messages from a RAM ring buffer via DMA instead of blocking for each message (about 4.3 ms per 50-byte line at
+// 115200 baud); messages that do not fit are handled by UART_LOG_OVERFLOW_POLICY: DropOldest, DropNewest, or Block
+constexpr bool USE_UART_DMA_LOGGER = true;
+constexpr UARTOverflowPolicy UART_LOG_OVERFLOW_POLICY = UARTOverflowPolicy::Block;
+
+// Encoding of the log messages: LogEncoding::Text (expanded on the device) or LogEncoding::Tokenized (log frames of the
+// message token and its raw arguments, a few bytes each, expanded on the host by Tools/log_decoder)
+constexpr LogEncoding LOG_ENCODING = LogEncoding::Text;
+
+// Runtime log filter at start-up, on top of the compile-time filter in project_tokenlog.h: bit n of LOG_LEVEL_MASK enables
+// LogLevel n and bit n of LOG_CATEGORY_MASK enables LogCategory n. Sending 'q' (quiet) via UART drops the per-sample Debug
+// messages, 'v' (verbose) enables all levels again; filtered messages are not formatted
+constexpr uint8_t LOG_LEVEL_MASK = LOG_LEVEL_MASK_ALL;
+constexpr uint8_t LOG_CATEGORY_MASK = LOG_CATEGORY_MASK_ALL;
+constexpr uint8_t LOG_COMMAND_QUIET = 'q';
+constexpr uint8_t LOG_COMMAND_VERBOSE = 'v';
+
+// Output of the samples at start-up: text lines (false), or binary telemetry packets of 16 bytes per sample with a sequence
+// number, timestamp, and CRC, parsed on the host by Tools/telemetry_dump (true). Switched at runtime by sending 'b' (binary)
+// or 't' (text) via UART; error and statistics messages are sent in either mode
+constexpr bool TELEMETRY_MODE = false;
+constexpr uint8_t TELEMETRY_COMMAND_BINARY = 'b';
+constexpr uint8_t TELEMETRY_COMMAND_TEXT = 't';
+
+// Log frames of the tokenized encoding contain zero bytes, which the telemetry parser takes as frame delimiters
+static_assert(!TELEMETRY_MODE || LOG_ENCODING == LogEncoding::Text, "Binary telemetry requires LogEncoding::Text");
+
+// Run the on-target benchmarks once at start-up (results are logged via UART)
+constexpr bool RUN_BENCHMARKS = false;
+
+using utility::logToken, utility::logTokenMessage;
+
+/**
+ * @brief Logs the EEPROM write cycle times measured by ACK polling and their histogram.
+ * @param eeprom Pointer to the EEPROM whose statistics are logged.
+ * @param uart_handle Pointer to the UART handle used for transmission.
+ */
+static void logWriteCycleStats(EEPROM *eeprom, UART_HandleTypeDef *uart_handle)
+{
+	const EEPROMWriteCycleStats &stats = eeprom->getWriteCycleStats();
+
+	if (stats.count == 0)
+	{
+		return;
+	}
+
+	logToken<LogToken::WriteCycleStats>(uart_handle, stats.count, stats.min_us, stats.total_us / stats.count, stats.max_us);
+
+	// Share of write cycles per 500 us bin in percent, the last bin collects everything from 5 ms upwards
+	if constexpr (tokenlog::isTokenCompiled(LogToken::WriteCycleHistogram))
+	{
+		int32_t histogram_shares[EEPROM_WRITE_CYCLE_HISTOGRAM_BINS];
+		for (size_t i = 0; i < EEPROM_WRITE_CYCLE_HISTOGRAM_BINS; i++)
+		{
+			histogram_shares[i] = stats.histogram[i] * 100 / stats.count;
+		}
+		logTokenMessage(uart_handle, LogToken::WriteCycleHistogram, histogram_shares, EEPROM_WRITE_CYCLE_HISTOGRAM_BINS);
+	}
+}
+
+/**
+ * @brief Logs the measured TMP100 conversion latencies and the I2C transactions per sample.
+ * @param temperature_sensor Pointer to the TMP100 whose statistics are logged.
+ * @param transaction_count The number of TMP100 I2C transactions since the last report.
+ * @param uart_handle Pointer to the UART handle used for transmission.
+ */
+static void logConversionStats(TMP100 *temperature_sensor, uint32_t transaction_count, UART_HandleTypeDef *uart_handle)
+{
+	const TMP100ConversionStats &stats = temperature_sensor->getConversionStats();
+
+	if (stats.count == 0)
+	{
+		return;
+	}
+
+	logToken<LogToken::TransactionStats>(uart_handle, temperature_sensor->getI2CAddress(), transaction_count,
+										 WRITE_CYCLE_REPORT_INTERVAL);
+
+	logToken<LogToken::ConversionStats>(uart_handle, stats.min_ms, stats.total_ms / stats.count, stats.max_ms,
+										stats.poll_count, stats.timeout_count);
+}
+
+/**
+ * @brief Logs the results of the background verification of the EEPROM log.
+ * @param eeprom_log Pointer to the EEPROM log whose health counters are logged.
+ * @param uart_handle Pointer to the UART handle used for transmission.
+ */
+static void logHealthCounters(EEPROMLog *eeprom_log, UART_HandleTypeDef *uart_handle)
+{
+	const LogHealthCounters &health = eeprom_log->getHealthCounters();
+
+	logToken<LogToken::LogHealth>(uart_handle, health.verified_page_count - health.failed_page_count,
+								  health.failed_page_count, health.read_error_count, health.scrub_pass_count,
+								  health.write_error_count);
+}
+
+/**
+ * @brief Logs the peak fill level of the UART ring buffer and the bytes dropped by its overflow policy.
+ * @param uart_handle Pointer to the UART handle used for transmission.
+ */
+static void logUARTLoggerStats(UART_HandleTypeDef *uart_handle)
+{
+	UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+	if (uart_logger == nullptr)
+	{
+		return;
+	}
+
+	logToken<LogToken::UARTLogStats>(uart_handle, uart_logger->getPeakBufferedByteCount(), UART_LOGGER_BUFFER_SIZE,
+									 uart_logger->getDroppedByteCount());
+}
+
+/**
+ * @brief Logs failed background EEPROM page writes. Called by the EEPROM log once it has handled the
+ * result of a record write, after EEPROMAsync has retried it.
+ * @param eeprom Pointer to the EEPROM that was written to.
+ * @param memory_address The address of the first byte of the page write.
+ * @param status The final status of the page write.
+ * @param context Pointer to the UART handle used for transmission.
+ */
+static void logEEPROMWriteResult(EEPROM *eeprom, uint16_t memory_address, HAL_StatusTypeDef status, void *context)
+{
+	if (status == HAL_OK)
+	{
+		return;
+	}
+
+	logToken<LogToken::EEPROMWriteFailed>(static_cast<UART_HandleTypeDef *>(context), eeprom->getI2CAddress(), memory_address);
+}
+
+/**
+ * @brief Retrieves the resolution bits the samples are stored at: the resolution of the sensors, or
+ * FILTER_RESOLUTION_BITS for filtered samples.
+ * @param temperature_sensor_array Pointer to the TMP100 sensors, which share one resolution.
+ * @return The resolution bits, from 0b00 (9-bit) to 0b11 (12-bit).
+ */
+static uint8_t getLogResolutionBits(TMP100Array *temperature_sensor_array)
+{
+	if constexpr (FILTER_TYPE != FilterType::None)
+	{
+		return FILTER_RESOLUTION_BITS;
+	}
+
+	return temperature_sensor_array->getSensor(0)->getResolutionBits();
+}
+
+/**
+ * @brief Runs a temperature conversion on every TMP100 and reads the results, advancing the
+ * background EEPROM page writes while the sensors convert.
+ * @param temperature_sensor_array Pointer to the TMP100 sensors.
+ * @param eeprom_async Pointer to the EEPROMAsync that shares the I2C bus.
+ * @param eeprom_log Pointer to the EEPROM log whose verification slot runs during the conversion, or
+ * nullptr to skip it.
+ * @param raw_temperature_data Pointer to an array where the raw temperature data will be stored, in
+ * ascending address order.
+ * @param sensor_mask Pointer to a variable where the mask of the sensors that were read will be stored.
+ * @param uart_handle Pointer to the UART handle used for transmission.
+ * @return HAL_TIMEOUT if a background transfer did not release the I2C bus, HAL_OK otherwise. Failed
+ * conversions and reads are logged, and their sensors are missing from the sensor mask.
+ */
+static HAL_StatusTypeDef acquireScan(TMP100Array *temperature_sensor_array, EEPROMAsync *eeprom_async, EEPROMLog *eeprom_log,
+									 uint16_t *raw_temperature_data, uint8_t *sensor_mask, UART_HandleTypeDef *uart_handle)
+{
+	HAL_StatusTypeDef status;
+
+	*sensor_mask = 0;
+
+	// Wait for a background EEPROM transfer to release the I2C bus
+	status = eeprom_async->waitForTransferComplete(I2C_BUS_TIMEOUT_MS);
+	if (status != HAL_OK)
+	{
+		logToken<LogToken::I2CBusTimeout>(uart_handle);
+		return HAL_TIMEOUT;
+	}
+
+	// Start a temperature conversion on every TMP100 back-to-back (returns without waiting for the results)
+	status = temperature_sensor_array->startConversions();
+	if (status != HAL_OK)
+	{
+		logToken<LogToken::ConversionTriggerFailed>(uart_handle);
+	}
+
+	// Verify a written log record while the TMP100 sensors convert (the previous commit has completed by now);
+	// failures are counted in the log health counters instead of being reported per sample
+	if (eeprom_log != nullptr)
+	{
+		eeprom_log->runVerificationSlot();
+	}
+
+	// Advance the background EEPROM page writes until the slowest conversion result is ready
+	while (!temperature_sensor_array->areConversionsDone())
+	{
+		eeprom_async->service();
+	}
+
+	// Wait for a transfer started during the conversion to release the I2C bus
+	status = eeprom_async->waitForTransferComplete(I2C_BUS_TIMEOUT_MS);
+	if (status != HAL_OK)
+	{
+		logToken<LogToken::I2CBusTimeout>(uart_handle);
+		return HAL_TIMEOUT;
+	}
+
+	// Read the raw temperature data from all TMP100 sensors back-to-back, in ascending address order
+	status = temperature_sensor_array->readTemperatures(raw_temperature_data, sensor_mask);
+	if (status != HAL_OK)
+	{
+		logToken<LogToken::TemperatureReadFailed>(uart_handle);
+	}
+
+	return HAL_OK;
+}
+
+/**
+ * @brief Passes a scan through the filters of its sensors and replaces the raw temperature data with
+ * the filtered temperatures, rounded to FILTER_RESOLUTION_BITS. The filters of sensors missing from
+ * the scan are reset.
+ * @param temperature_sensor_array Pointer to the TMP100 sensors.
+ * @param temperature_filters Pointer to the filters, indexed by sensor tag (address - 0x48).
+ * @param raw_temperature_data Pointer to the raw temperature data of the scan, in ascending address order.
+ * @param sensor_mask The mask of the sensors in the scan.
+ */
+static void filterScan(TMP100Array *temperature_sensor_array, TemperatureFilter *temperature_filters,
+					   uint16_t *raw_temperature_data, uint8_t sensor_mask)
+{
+	constexpr uint8_t fraction_shift = 7 - FILTER_RESOLUTION_BITS;
+	uint8_t sample_index = 0;
+
+	for (uint8_t i = 0; i < temperature_sensor_array->getSensorCount(); i++)
+	{
+		TMP100 *sensor = temperature_sensor_array->getSensor(i);
+		uint8_t sensor_tag = sensor->getI2CAddress() - TMP100_BASE_ADDRESS;
+
+		if (!(sensor_mask & (1 << sensor_tag)))
+		{
+			temperature_filters[sensor_tag].reset();
+			continue;
+		}
+
+		int32_t filtered_temperature_data =
+			temperature_filters[sensor_tag].update(sensor->convertRawTemperatureDataToQ8_8(raw_temperature_data[sample_index]));
+
+		// Round to the stored resolution, in the left-justified format of the Temperature Register
+		filtered_temperature_data += (1 << fraction_shift) >> 1;
+		raw_temperature_data[sample_index++] = static_cast<uint16_t>(filtered_temperature_data & (0xFFFF << fraction_shift));
+	}
+}
+
+/**
+ * @brief Checks whether any sample of a scan differs from the last logged scan by at least the
+ * event band.
+ * @param samples Pointer to the raw temperature data of the scan.
+ * @param logged_samples Pointer to the raw temperature data of the last logged scan.
+ * @param scan_length The number of samples in both scans.
+ * @return True if a sample left the band, false otherwise.
+ */
+static bool isScanOutsideBand(const uint16_t *samples, const uint16_t *logged_samples, uint8_t scan_length)
+{
+	for (uint8_t i = 0; i < scan_length; i++)
+	{
+		int32_t difference = static_cast<int16_t>(samples[i]) - static_cast<int16_t>(logged_samples[i]);
+
+		if (abs(difference) >= LOG_EVENT_BAND)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Captures a burst at each selected resolution, streams the buffered readings via UART as
+ * "time in us, temperature" lines, and logs the achieved sample rate and jitter of each burst.
+ * @param temperature_sensor Pointer to the TMP100 to sample.
+ * @param uart_handle Pointer to the UART handle used for transmission.
+ */
+static void runBurstAcquisition(TMP100 *temperature_sensor, UART_HandleTypeDef *uart_handle)
+{
+	// Static, as the readings and their timestamps take 6 KiB
+	static TMP100Burst burst = TMP100Burst(temperature_sensor);
+
+	for (uint8_t resolution_bits = 0; resolution_bits <= 0b11; resolution_bits++)
+	{
+		if (!(BURST_RESOLUTION_MASK & (1 << resolution_bits)))
+		{
+			continue;
+		}
+
+		HAL_StatusTypeDef status = burst.capture(resolution_bits, BURST_WINDOW_MS, BURST_PERIOD_MS);
+		if (status != HAL_OK)
+		{
+			logToken<LogToken::BurstCaptureFailed>(uart_handle, 9 + resolution_bits);
+		}
+
+		// The readings are Q8.8 values with at most 4 fraction bits (12-bit), which ten-thousandths of a degree represent
+		// exactly at any resolution
+		for (uint16_t i = 0; i < burst.getSampleCount(); i++)
+		{
+			int32_t temperature_data = static_cast<int16_t>(burst.getSample(i)) * 625 / 16;
+			logToken<LogToken::BurstSample>(uart_handle, burst.getTimestamp(i), temperature_data);
+		}
+
+		const TMP100BurstStats &stats = burst.getStats();
+		logToken<LogToken::BurstStats>(uart_handle, 9 + resolution_bits, stats.sample_count, burst.getSampleRate(),
+									   stats.overrun_count);
+
+		if (stats.sample_count >= 2)
+		{
+			// Deviation of the shortest and the longest interval between reads from the period
+			logToken<LogToken::BurstJitter>(uart_handle, stats.min_interval_us - stats.period_us,
+											stats.max_interval_us - stats.period_us, burst.getMeanJitter());
+		}
+	}
+}
+
+/**
+ * @brief Handles a command byte received via UART: switches between the text output and the binary
+ * telemetry, or between the quiet and the verbose runtime log level mask. Polled once per sample
+ * without waiting, so only the first byte received in between counts: the USART keeps it in the data
+ * register and drops the following bytes with an overrun error. The binary telemetry command is
+ * ignored with the tokenized log encoding.
+ * @param uart_handle Pointer to the UART handle used for reception and transmission.
+ * @param is_telemetry_mode Pointer to the output mode, true for binary telemetry.
+ */
+static void pollUARTCommand(UART_HandleTypeDef *uart_handle, bool *is_telemetry_mode)
+{
+	uint8_t command;
+
+	if (HAL_UART_Receive(uart_handle, &command, 1, 0) != HAL_OK)
+	{
+		return;
+	}
+
+	if (command == TELEMETRY_COMMAND_BINARY && LOG_ENCODING == LogEncoding::Text && !*is_telemetry_mode)
+	{
+		logToken<LogToken::OutputModeTelemetry>(uart_handle);
+		*is_telemetry_mode = true;
+	}
+	else if (command == TELEMETRY_COMMAND_TEXT && *is_telemetry_mode)
+	{
+		*is_telemetry_mode = false;
+		logToken<LogToken::OutputModeText>(uart_handle);
+	}
+	else if (command == LOG_COMMAND_QUIET || command == LOG_COMMAND_VERBOSE)
+	{
+		uint8_t level_mask = (command == LOG_COMMAND_QUIET) ? tokenlog::getLevelMask(LogLevel::Info) : LOG_LEVEL_MASK_ALL;
+		utility::setLogLevelMask(level_mask);
+		logToken<LogToken::LogLevelMask>(uart_handle, level_mask);
+	}
+}
+
+/**
+ * @brief Waits for the specified time while advancing the background EEPROM page writes.
+ * @param eeprom_async Pointer to the EEPROMAsync to service.
+ * @param delay_ms The time to wait in milliseconds.
+ */
+static void delayWhileServicing(EEPROMAsync *eeprom_async, uint32_t delay_ms)
+{
+	uint32_t start_ms = HAL_GetTick();
+
+	while (HAL_GetTick() - start_ms < delay_ms)
+	{
+		eeprom_async->service();
+	}
+}
 
 void project_main(I2C_HandleTypeDef *i2c_handle, UART_HandleTypeDef *uart_handle)
 {
 	HAL_StatusTypeDef status;
-	char status_message[64];
+	uint32_t sample_count = 0;
+	uint32_t reported_transaction_counts[TMP100_ARRAY_MAX_SENSORS] = {};
+	uint16_t logged_temperature_data[TMP100_ARRAY_MAX_SENSORS] = {};
+	uint8_t logged_sensor_mask = 0;
+	uint32_t held_sample_count = 0;
+	uint32_t event_count = 0;
+	uint32_t reported_resolution_change_count = 0;
+	bool is_telemetry_mode = TELEMETRY_MODE;
+	uint16_t telemetry_sequence = 0;
+	bool is_log_error = false;
+
+	// Enable the cycle counter used to time the EEPROM write cycles and the log recovery
+	utility::enableCycleCounter();
 
-	// Initialize the TMP100 temperature sensor assuming ADDO and ADD1 are grounded (binary: 0b01001000)
+	// Register the DMA logger of the UART, so that logging a message only copies it into the ring buffer (static, so that
+	// the last messages are still sent if the program terminates)
+	if constexpr (USE_UART_DMA_LOGGER)
+	{
+		[[maybe_unused]] static UARTLogger uart_logger = UARTLogger(uart_handle, UART_LOG_OVERFLOW_POLICY);
+	}
+
+	// Send the log messages as text or as log frames; the table hash lets the decoder detect a token table that does not
+	// match the firmware
+	utility::setLogEncoding(LOG_ENCODING);
+	utility::setLogLevelMask(LOG_LEVEL_MASK);
+	utility::setLogCategoryMask(LOG_CATEGORY_MASK);
+	if constexpr (LOG_ENCODING == LogEncoding::Tokenized)
+	{
+		logToken<LogToken::TableHash>(uart_handle, tokenlog::calculateTableHash());
+	}
+
+	// TMP100 address assuming ADDO and ADD1 are grounded (binary: 0b01001000)
 	uint8_t temperature_sensor_i2c_address = 0x48;
+
+	// 24FC256 EEPROM address assuming ADDO, ADD1, and ADD2 are grounded (binary: 0b01010000)
+	// Note: '1010' corresponds to the 4-bit control code
+	uint8_t eeprom_i2c_address = 0x50;
+
+	if constexpr (RUN_BENCHMARKS)
+	{
+		// Runs before the TMP100 object starts tracking the Pointer Register of the sensor
+		benchmark::runI2CReadBenchmark(i2c_handle, temperature_sensor_i2c_address, eeprom_i2c_address, uart_handle);
+	}
+
+	// Initialize the TMP100 temperature sensor
 	TMP100 temperature_sensor = TMP100(i2c_handle, temperature_sensor_i2c_address);
 
-	// Configure the TMP100 for Shutdown Mode and a Resolution of 0.25C by setting the SD-bit the and R0-bit HIGH (binary: 0b00100001)
-	status = temperature_sensor.writeConfigurationReg(0x21);
+	// Convert on all TMP100 sensors on the bus in parallel; further sensors (0x49 to 0x4F) are added to this list
+	TMP100 *temperature_sensors[] = {&temperature_sensor};
+	TMP100Array temperature_sensor_array = TMP100Array(temperature_sensors, sizeof(temperature_sensors) / sizeof(temperature_sensors[0]));
+
+	// One filter per sensor, indexed by sensor tag (address - 0x48)
+	TemperatureFilter temperature_filters[TMP100_ARRAY_MAX_SENSORS];
+
+	for (uint8_t i = 0; i < temperature_sensor_array.getSensorCount(); i++)
+	{
+		TMP100 *sensor = temperature_sensor_array.getSensor(i);
+
+		// Configure the TMP100 for Shutdown Mode and a Resolution of 0.25C by setting the SD-bit the and R0-bit HIGH (binary: 0b00100001)
+		status = sensor->writeConfigurationReg(0x21);
+		if (status != HAL_OK)
+		{
+			// Turn off the on-board green LED to indicate configuration failure
+			HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_RESET);
+
+			logToken<LogToken::SensorConfigurationFailed>(uart_handle, sensor->getI2CAddress());
+			return;
+		}
+
+		// Apply the configured detection of completed conversions (see TMP100_WAIT_MODE)
+		sensor->setWaitMode(TMP100_WAIT_MODE, TMP100_POLL_INTERVAL_MS);
+
+		temperature_filters[sensor->getI2CAddress() - TMP100_BASE_ADDRESS] = TemperatureFilter(FILTER_TYPE, FILTER_LENGTH);
+	}
+
+	if constexpr (BURST_MODE)
+	{
+		// Runs before the EEPROM log shares the I2C bus
+		runBurstAcquisition(temperature_sensor_array.getSensor(0), uart_handle);
+	}
+
+	TMP100ResolutionScheduler resolution_scheduler =
+		TMP100ResolutionScheduler(RESOLUTION_POLICY, temperature_sensor_array.getSensor(0)->getResolutionBits());
+
+	// Turn on the on-board green LED to indicate configuration success
+	HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET);
+
+	// Initialize the 24FC256 EEPROM
+	EEPROM eeprom = EEPROM(i2c_handle, eeprom_i2c_address);
+
+	// Stripe the log across all 24FC256 EEPROMs on the bus; further chips (0x51 to 0x57) are added to this list
+	EEPROM *eeprom_chips[] = {&eeprom};
+	EEPROMArray eeprom_array = EEPROMArray(eeprom_chips, sizeof(eeprom_chips) / sizeof(eeprom_chips[0]));
+
+	if constexpr (RUN_BENCHMARKS)
+	{
+		benchmark::runEEPROMReadBenchmark(&eeprom, uart_handle);
+	}
+
+	// Store samples in page-sized log records and resume after the newest record written before the reset
+	EEPROMLog eeprom_log = EEPROMLog(&eeprom_array);
+	uint32_t recovery_start_cycles = utility::getCycleCount();
+	status = eeprom_log.recoverHead();
+	uint32_t recovery_us = utility::convertCyclesToMicroseconds(utility::getCycleCount() - recovery_start_cycles);
 	if (status != HAL_OK)
 	{
 		// Turn off the on-board green LED to indicate configuration failure
 		HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_RESET);
 
-		snprintf(status_message, sizeof(status_message), "Error: Failed to configure TMP100! Terminating program.\r\n");
-		logStatusMessage(uart_handle, status_message);
+		logToken<LogToken::LogRecoveryFailed>(uart_handle);
 		return;
 	}
 
-	// Turn on the on-board green LED to indicate configuration success
-	HAL_GPIO_WritePin(GPIOA, GPIO_PIN_5, GPIO_PIN_SET);
+	// Select the storage format of new samples (closes a resumed record stored in another format); all sensors
+	// share the resolution of the first one, filtered samples are stored at FILTER_RESOLUTION_BITS
+	status = eeprom_log.setSampleFormat(LOG_SAMPLE_ENCODING | getLogResolutionBits(&temperature_sensor_array));
+	if (status != HAL_OK)
+	{
+		logToken<LogToken::LogFormatFailed>(uart_handle);
+	}
 
-	// Initialize the 24FC256 EEPROM assuming ADDO, ADD1, and ADD2 are grounded (binary: 0b01010000)
-	// Note: '1010' corresponds to the 4-bit control code
-	uint8_t eeprom_i2c_address = 0x50;
-	EEPROM eeprom = EEPROM(i2c_handle, eeprom_i2c_address);
+	logToken<LogToken::LogResumed>(uart_handle, eeprom_log.getCurrentWriteAddress(), recovery_us);
+
+	if constexpr (RUN_BENCHMARKS)
+	{
+		benchmark::runLogDecodeBenchmark(&eeprom_log, uart_handle);
+		benchmark::runDeltaCodecBenchmark(&eeprom_log, uart_handle);
+		benchmark::runTemperatureFormatBenchmark(&temperature_sensor, uart_handle);
+		benchmark::runFilterBenchmark(uart_handle);
+		benchmark::runUARTLogBenchmark(uart_handle);
+		benchmark::runTokenLogBenchmark(uart_handle);
+	}
+
+	// Write records in the background; the TMP100 shares the I2C bus and is only accessed between transfers
+	EEPROMAsync eeprom_async = EEPROMAsync(i2c_handle);
+	eeprom_log.setWriteResultCallback(logEEPROMWriteResult, uart_handle);
+	if constexpr (USE_ASYNC_EEPROM_WRITES)
+	{
+		eeprom_log.setAsyncWriter(&eeprom_async);
+	}
+	eeprom_log.setVerifyPolicy(LOG_VERIFY_POLICY);
 
 	while (1)
 	{
-		// Trigger a temperature conversion on the TMP100
-		status = temperature_sensor.triggerOneShotTemperatureConversion();
+		pollUARTCommand(uart_handle, &is_telemetry_mode);
+
+		// Acquire OVERSAMPLING_COUNT scans and pass them through the filters, keeping the last filter output
+		uint16_t raw_temperature_data[TMP100_ARRAY_MAX_SENSORS];
+		uint8_t read_sensor_mask = 0;
+		status = HAL_OK;
+		for (uint8_t i = 0; i < OVERSAMPLING_COUNT && status == HAL_OK; i++)
+		{
+			status = acquireScan(&temperature_sensor_array, &eeprom_async, (i == 0) ? &eeprom_log : nullptr,
+								 raw_temperature_data, &read_sensor_mask, uart_handle);
+
+			if constexpr (FILTER_TYPE != FilterType::None)
+			{
+				filterScan(&temperature_sensor_array, temperature_filters, raw_temperature_data, read_sensor_mask);
+			}
+		}
+
 		if (status != HAL_OK)
 		{
-			snprintf(status_message, sizeof(status_message), "Error: Failed to trigger One-Shot temperature conversion!\r\n");
-			logStatusMessage(uart_handle, status_message);
-			HAL_Delay(DELAY_MS);
+			delayWhileServicing(&eeprom_async, DELAY_MS);
 			continue;
 		}
 
-		// Read the raw temperature data from the TMP100
-		uint16_t raw_temperature_data;
-		status = temperature_sensor.readTemperatureReg(&raw_temperature_data);
-		if (status != HAL_OK)
+		if (read_sensor_mask == 0)
 		{
-			snprintf(status_message, sizeof(status_message), "Error: Failed to read temperature data from TMP100!\r\n");
-			logStatusMessage(uart_handle, status_message);
-			HAL_Delay(DELAY_MS);
+			delayWhileServicing(&eeprom_async, DELAY_MS);
 			continue;
 		}
 
-		// Convert raw temperature data to Celsius and log the result
-		float celsius_temperature_data = temperature_sensor.convertRawTemperatureDataToCelsius(raw_temperature_data);
-		snprintf(status_message, sizeof(status_message), "Current Temperature: %.02f°C.\r\n", celsius_temperature_data);
-		logStatusMessage(uart_handle, status_message);
+		uint8_t scan_length = __builtin_popcount(read_sensor_mask);
 
-		// Get the current write address for the EEPROM
-		uint16_t current_address = eeprom.getCurrentWriteAddress();
+		// Keep the scan in Q8.8 format for the resolution scheduler and the telemetry, before the event logging mode replaces
+		// it (the raw temperature data is in the Q8.8 format of the Temperature Register, at the resolution of the log)
+		int16_t q8_8_temperature_data[TMP100_ARRAY_MAX_SENSORS];
+		for (uint8_t i = 0; i < scan_length; i++)
+		{
+			q8_8_temperature_data[i] = static_cast<int16_t>(raw_temperature_data[i]);
+		}
+
+		// In the event logging mode, a scan within the band around the last logged scan is stored as a repeat of it,
+		// which the delta format packs into a run of a few bits per sample
+		bool is_event = true;
+		if constexpr (LOG_EVENT_MODE)
+		{
+			is_event = read_sensor_mask != logged_sensor_mask || held_sample_count >= LOG_EVENT_MAX_HOLD ||
+					   isScanOutsideBand(raw_temperature_data, logged_temperature_data, scan_length);
+
+			if (is_event)
+			{
+				memcpy(logged_temperature_data, raw_temperature_data, scan_length * sizeof(raw_temperature_data[0]));
+				logged_sensor_mask = read_sensor_mask;
+				held_sample_count = 0;
+				event_count++;
+			}
+			else
+			{
+				memcpy(raw_temperature_data, logged_temperature_data, scan_length * sizeof(raw_temperature_data[0]));
+				held_sample_count++;
+			}
+		}
+
+		// Send every sample of the scan as a telemetry packet (flagged if the scan is logged), or convert the samples of a
+		// logged scan to hundredths of a degree Celsius and log them as text (no floating point)
+		TelemetrySample telemetry_sample = {};
+		telemetry_sample.timestamp_ms = HAL_GetTick();
+		telemetry_sample.status_flags = getLogResolutionBits(&temperature_sensor_array) |
+										((FILTER_TYPE != FilterType::None) ? TELEMETRY_FLAG_FILTERED : 0) |
+										(is_event ? TELEMETRY_FLAG_EVENT : 0) | (is_log_error ? TELEMETRY_FLAG_LOG_ERROR : 0);
+		is_log_error = false;
+
+		uint8_t sample_index = 0;
+		for (uint8_t i = 0; i < temperature_sensor_array.getSensorCount() && (is_event || is_telemetry_mode); i++)
+		{
+			TMP100 *sensor = temperature_sensor_array.getSensor(i);
 
-		// Write the raw temperature data to the EEPROM
-		status = eeprom.writeTwoBytes(static_cast<uint16_t>(raw_temperature_data));
+			if (!(read_sensor_mask & (1 << (sensor->getI2CAddress() - TMP100_BASE_ADDRESS))))
+			{
+				continue;
+			}
+
+			if (is_telemetry_mode)
+			{
+				telemetry_sample.sequence = telemetry_sequence++;
+				telemetry_sample.sensor_id = sensor->getI2CAddress();
+				telemetry_sample.raw_sample = static_cast<uint16_t>(q8_8_temperature_data[sample_index++]);
+				utility::logTelemetrySample(uart_handle, telemetry_sample);
+				continue;
+			}
+
+			int16_t centi_celsius_temperature_data = utility::convertQ8_8ToCentiCelsius(static_cast<int16_t>(raw_temperature_data[sample_index++]));
+			logToken<LogToken::CurrentTemperature>(uart_handle, sensor->getI2CAddress(), centi_celsius_temperature_data);
+		}
+
+		// Tag the log records with the sensors of the scan once several sensors share the log (closes the record
+		// if a sensor stopped responding)
+		uint8_t log_sensor_mask = (temperature_sensor_array.getSensorCount() > 1) ? read_sensor_mask : 0;
+		status = eeprom_log.setSensorMask(log_sensor_mask);
 		if (status != HAL_OK)
 		{
-			snprintf(status_message, sizeof(status_message), "Error: Failed to write temperature data to EEPROM!\r\n");
-			logStatusMessage(uart_handle, status_message);
-			HAL_Delay(DELAY_MS);
+			logToken<LogToken::LogSensorMaskFailed>(uart_handle);
+			is_log_error = true;
+			delayWhileServicing(&eeprom_async, DELAY_MS);
 			continue;
 		}
 
-		// Log the memory write result
-		snprintf(status_message, sizeof(status_message), "Wrote 0x%04X to EEPROM at address 0x%04X.\r\n",
-				 static_cast<uint16_t>(raw_temperature_data), current_address);
-		logStatusMessage(uart_handle, status_message);
+		// Get the current write address for the EEPROM
+		uint32_t current_address = eeprom_log.getCurrentWriteAddress();
 
-		// Read the raw temperature data from the EEPROM
-		status = eeprom.readTwoBytes(current_address, &raw_temperature_data);
+		// Append one sample per sensor to the log, committing the record to the EEPROM once it is full
+		status = eeprom_log.appendScan(raw_temperature_data);
 		if (status != HAL_OK)
 		{
-			snprintf(status_message, sizeof(status_message), "Error: Failed to read temperature data from EEPROM!\r\n");
-			logStatusMessage(uart_handle, status_message);
-			HAL_Delay(DELAY_MS);
+			logToken<LogToken::LogWriteFailed>(uart_handle);
+			is_log_error = true;
+			delayWhileServicing(&eeprom_async, DELAY_MS);
 			continue;
 		}
 
-		// Log the memory read result
-		snprintf(status_message, sizeof(status_message), "Read 0x%04X from EEPROM at address 0x%04X.\r\n",
-				 static_cast<uint16_t>(raw_temperature_data), current_address);
-		logStatusMessage(uart_handle, status_message);
+		// Log the memory write result (the telemetry packets carry it in their flags)
+		if (is_event && !is_telemetry_mode)
+		{
+			logToken<LogToken::SamplesWritten>(uart_handle, scan_length, current_address);
+		}
+
+		sample_count++;
+
+		// Write the partially filled log record to the EEPROM periodically (one sample per sensor and scan), or on each
+		// event in the event logging mode
+		bool is_flush_due = LOG_EVENT_MODE ? is_event : (sample_count % LOG_FLUSH_INTERVAL == 0);
+		if (is_flush_due)
+		{
+			status = eeprom_log.flush();
+			if (status != HAL_OK)
+			{
+				logToken<LogToken::LogFlushFailed>(uart_handle);
+				is_log_error = true;
+			}
+		}
+
+		// Pick the resolution of the next conversion (shared by all sensors) and store the following samples in records of
+		// that resolution; a resolution change counts as an event, so that held samples are not stored at another resolution
+		if constexpr (USE_RESOLUTION_SCHEDULER)
+		{
+			uint8_t resolution_bits = resolution_scheduler.update(q8_8_temperature_data, scan_length);
+
+			if (resolution_bits != temperature_sensor_array.getSensor(0)->getResolutionBits())
+			{
+				status = temperature_sensor_array.setResolutionBits(resolution_bits);
+				if (status != HAL_OK)
+				{
+					logToken<LogToken::ResolutionChangeFailed>(uart_handle);
+				}
+
+				status = eeprom_log.setSampleFormat(LOG_SAMPLE_ENCODING | getLogResolutionBits(&temperature_sensor_array));
+				if (status != HAL_OK)
+				{
+					logToken<LogToken::LogFormatFailed>(uart_handle);
+					is_log_error = true;
+				}
+
+				logged_sensor_mask = 0;
+			}
+		}
+
+		// Periodically log the measured EEPROM write cycle times, the log health, and the conversion latencies
+		if (sample_count % WRITE_CYCLE_REPORT_INTERVAL == 0)
+		{
+			for (uint8_t i = 0; i < eeprom_array.getChipCount(); i++)
+			{
+				logWriteCycleStats(eeprom_array.getChip(i), uart_handle);
+			}
+
+			logHealthCounters(&eeprom_log, uart_handle);
+			logUARTLoggerStats(uart_handle);
+
+			if constexpr (USE_RESOLUTION_SCHEDULER)
+			{
+				uint32_t resolution_change_count = resolution_scheduler.getChangeCount();
+				logToken<LogToken::ResolutionStats>(uart_handle, 9 + resolution_scheduler.getResolutionBits(),
+													resolution_change_count - reported_resolution_change_count,
+													resolution_scheduler.getChangeRate());
+				reported_resolution_change_count = resolution_change_count;
+			}
+
+			if constexpr (LOG_EVENT_MODE)
+			{
+				logToken<LogToken::EventStats>(uart_handle, event_count, WRITE_CYCLE_REPORT_INTERVAL);
+				event_count = 0;
+			}
+
+			for (uint8_t i = 0; i < temperature_sensor_array.getSensorCount(); i++)
+			{
+				TMP100 *sensor = temperature_sensor_array.getSensor(i);
+				uint32_t transaction_count = sensor->getTransactionCount();
+				logConversionStats(sensor, transaction_count - reported_transaction_counts[i], uart_handle);
+				reported_transaction_counts[i] = transaction_count;
+			}
+		}
 
-		HAL_Delay(DELAY_MS);
+		delayWhileServicing(&eeprom_async, DELAY_MS);
 	}
 }
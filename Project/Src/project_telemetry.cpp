@@ -0,0 +1,178 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_telemetry.cpp
+ * @brief Implementation file for the binary telemetry packets, shared with the host-side parser.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "project_telemetry.h"
+
+#include "project_codec.h"
+
+// Largest COBS code: a block of 254 non-zero bytes without a following zero byte
+constexpr uint8_t COBS_MAX_CODE = 0xFF;
+
+namespace
+{
+    /**
+     * @brief Stores a 16-bit value in big-endian byte order.
+     * @param buffer Pointer to the two bytes.
+     * @param value The value to store.
+     */
+    void storeUInt16(uint8_t *buffer, uint16_t value)
+    {
+        buffer[0] = static_cast<uint8_t>(value >> 8);
+        buffer[1] = static_cast<uint8_t>(value);
+    }
+
+    /**
+     * @brief Loads a 16-bit value in big-endian byte order.
+     * @param buffer Pointer to the two bytes.
+     * @return The value.
+     */
+    uint16_t loadUInt16(const uint8_t *buffer)
+    {
+        return static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+    }
+}
+
+namespace telemetry
+{
+    /**
+     * @brief COBS-encodes a block of data: every zero byte is replaced by the distance to the next
+     * one, and a code byte in front holds the distance to the first (0xFF for 254 non-zero bytes
+     * without a zero byte).
+     * @param data Pointer to the data.
+     * @param length The number of bytes.
+     * @param encoded Pointer to a buffer of at least length + length / 254 + 1 bytes where the
+     * encoded data, which contains no zero byte, will be stored.
+     * @return The length of the encoded data in bytes.
+     */
+    size_t encodeCOBS(const uint8_t *data, size_t length, uint8_t *encoded)
+    {
+        size_t code_index = 0;
+        size_t encoded_length = 1;
+        uint8_t code = 1;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            if (data[i] != 0)
+            {
+                encoded[encoded_length++] = data[i];
+                code++;
+            }
+
+            if (data[i] == 0 || code == COBS_MAX_CODE)
+            {
+                encoded[code_index] = code;
+                code_index = encoded_length++;
+                code = 1;
+            }
+        }
+
+        encoded[code_index] = code;
+
+        return encoded_length;
+    }
+
+    /**
+     * @brief Decodes a block of COBS-encoded data (without the frame delimiters).
+     * @param encoded Pointer to the encoded data.
+     * @param length The number of encoded bytes.
+     * @param data Pointer to a buffer of at least length bytes where the data will be stored.
+     * @return The length of the data in bytes, or 0 if the encoding is invalid.
+     */
+    size_t decodeCOBS(const uint8_t *encoded, size_t length, uint8_t *data)
+    {
+        size_t data_length = 0;
+        size_t i = 0;
+
+        while (i < length)
+        {
+            uint8_t code = encoded[i++];
+
+            if (code == 0 || i + code - 1 > length)
+            {
+                return 0;
+            }
+
+            for (uint8_t j = 1; j < code; j++)
+            {
+                if (encoded[i] == 0)
+                {
+                    return 0;
+                }
+
+                data[data_length++] = encoded[i++];
+            }
+
+            // A code below 0xFF stands for a zero byte, except for the implicit one at the end
+            if (code < COBS_MAX_CODE && i < length)
+            {
+                data[data_length++] = 0;
+            }
+        }
+
+        return data_length;
+    }
+
+    /**
+     * @brief Encodes a telemetry frame: the packet with its CRC, COBS-encoded, between two delimiters.
+     * @param sample The contents of the packet.
+     * @param frame Pointer to a buffer of at least TELEMETRY_FRAME_SIZE bytes where the frame will be stored.
+     * @return The length of the frame in bytes (TELEMETRY_FRAME_SIZE).
+     */
+    size_t encodeFrame(const TelemetrySample &sample, uint8_t *frame)
+    {
+        uint8_t packet[TELEMETRY_PACKET_SIZE];
+
+        packet[0] = TELEMETRY_PACKET_TYPE_SAMPLE;
+        storeUInt16(&packet[1], sample.sequence);
+        storeUInt16(&packet[3], static_cast<uint16_t>(sample.timestamp_ms >> 16));
+        storeUInt16(&packet[5], static_cast<uint16_t>(sample.timestamp_ms));
+        packet[7] = sample.sensor_id;
+        storeUInt16(&packet[8], sample.raw_sample);
+        packet[10] = sample.status_flags;
+        storeUInt16(&packet[11], codec::calculateCRC16(packet, TELEMETRY_PACKET_SIZE - 2));
+
+        size_t length = 0;
+
+        frame[length++] = TELEMETRY_FRAME_DELIMITER;
+        length += encodeCOBS(packet, TELEMETRY_PACKET_SIZE, &frame[length]);
+        frame[length++] = TELEMETRY_FRAME_DELIMITER;
+
+        return length;
+    }
+
+    /**
+     * @brief Decodes a COBS-encoded telemetry packet received between two delimiters and checks its
+     * length, type, and CRC.
+     * @param encoded Pointer to the bytes between the delimiters.
+     * @param length The number of bytes.
+     * @param sample Pointer to a variable where the contents of the packet will be stored.
+     * @return True if the packet is valid, false otherwise.
+     */
+    bool decodePacket(const uint8_t *encoded, size_t length, TelemetrySample *sample)
+    {
+        uint8_t packet[TELEMETRY_ENCODED_PACKET_SIZE];
+
+        if (length != TELEMETRY_ENCODED_PACKET_SIZE || decodeCOBS(encoded, length, packet) != TELEMETRY_PACKET_SIZE)
+        {
+            return false;
+        }
+
+        if (packet[0] != TELEMETRY_PACKET_TYPE_SAMPLE ||
+            loadUInt16(&packet[11]) != codec::calculateCRC16(packet, TELEMETRY_PACKET_SIZE - 2))
+        {
+            return false;
+        }
+
+        sample->sequence = loadUInt16(&packet[1]);
+        sample->timestamp_ms = (static_cast<uint32_t>(loadUInt16(&packet[3])) << 16) | loadUInt16(&packet[5]);
+        sample->sensor_id = packet[7];
+        sample->raw_sample = loadUInt16(&packet[8]);
+        sample->status_flags = packet[10];
+
+        return true;
+    }
+}
@@ -0,0 +1,349 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file project_tokenlog.cpp
+ * @brief Implementation file for the tokenized log messages, shared with the host-side decoder.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "project_tokenlog.h"
+
+// Largest number of decimal places of a %.Nf conversion (a 32-bit value has 10 digits)
+constexpr uint8_t LOG_MAX_DECIMAL_PLACES = 9;
+
+// Largest number of bytes of a varint (32 bits in groups of 7)
+constexpr uint8_t LOG_MAX_VARINT_SIZE = 5;
+
+// FNV-1a parameters of the table hash
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+
+namespace
+{
+    // Output position of expandMessage, which counts the characters that do not fit
+    struct TextWriter
+    {
+        char *buffer;
+        size_t buffer_size;
+        size_t length;
+    };
+
+    /**
+     * @brief Appends a character to the expanded message if there is room for it and the
+     * terminating null character.
+     * @param writer Pointer to the output position.
+     * @param character The character to append.
+     */
+    void appendCharacter(TextWriter *writer, char character)
+    {
+        if (writer->length + 1 < writer->buffer_size)
+        {
+            writer->buffer[writer->length] = character;
+        }
+
+        writer->length++;
+    }
+
+    /**
+     * @brief Converts an unsigned value to digits, most significant digit first.
+     * @param digits Pointer to a buffer of at least 11 characters where the digits will be stored.
+     * @param value The value to convert.
+     * @param base The number base (10 or 16).
+     * @param is_upper_case True for upper-case hexadecimal digits.
+     * @return The number of digits (at least one).
+     */
+    uint8_t formatDigits(char *digits, uint32_t value, uint8_t base, bool is_upper_case)
+    {
+        const char *digit_characters = is_upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+        char reversed_digits[10];
+        uint8_t digit_count = 0;
+
+        do
+        {
+            reversed_digits[digit_count++] = digit_characters[value % base];
+            value /= base;
+        } while (value > 0);
+
+        for (uint8_t i = 0; i < digit_count; i++)
+        {
+            digits[i] = reversed_digits[digit_count - 1 - i];
+        }
+
+        return digit_count;
+    }
+
+    /**
+     * @brief Appends a converted field, padded to the field width with spaces in front of the sign
+     * or with zeros behind it.
+     * @param writer Pointer to the output position.
+     * @param field Pointer to the characters of the field without the sign.
+     * @param field_length The number of characters of the field.
+     * @param is_negative True to prefix the field with a minus sign.
+     * @param width The minimum field width including the sign.
+     * @param is_zero_padded True to pad with zeros instead of spaces.
+     */
+    void appendField(TextWriter *writer, const char *field, uint8_t field_length, bool is_negative, uint8_t width,
+                     bool is_zero_padded)
+    {
+        uint8_t total_length = field_length + (is_negative ? 1 : 0);
+        uint8_t padding = (width > total_length) ? width - total_length : 0;
+
+        if (!is_zero_padded)
+        {
+            for (uint8_t i = 0; i < padding; i++)
+            {
+                appendCharacter(writer, ' ');
+            }
+        }
+
+        if (is_negative)
+        {
+            appendCharacter(writer, '-');
+        }
+
+        if (is_zero_padded)
+        {
+            for (uint8_t i = 0; i < padding; i++)
+            {
+                appendCharacter(writer, '0');
+            }
+        }
+
+        for (uint8_t i = 0; i < field_length; i++)
+        {
+            appendCharacter(writer, field[i]);
+        }
+    }
+
+    /**
+     * @brief Formats a fixed-point value with the specified number of decimal places, without the sign.
+     * @param field Pointer to a buffer of at least 12 characters where the field will be stored.
+     * @param magnitude The absolute value, scaled by 10^decimal_places.
+     * @param decimal_places The number of decimal places (0 to LOG_MAX_DECIMAL_PLACES).
+     * @return The number of characters of the field.
+     */
+    uint8_t formatFixedPointField(char *field, uint32_t magnitude, uint8_t decimal_places)
+    {
+        char digits[10];
+        uint8_t digit_count = formatDigits(digits, magnitude, 10, false);
+        uint8_t leading_zero_count = (digit_count <= decimal_places) ? decimal_places + 1 - digit_count : 0;
+        uint8_t field_length = 0;
+
+        for (uint8_t i = 0; i < leading_zero_count + digit_count; i++)
+        {
+            if (i == leading_zero_count + digit_count - decimal_places)
+            {
+                field[field_length++] = '.';
+            }
+
+            field[field_length++] = (i < leading_zero_count) ? '0' : digits[i - leading_zero_count];
+        }
+
+        return field_length;
+    }
+}
+
+namespace tokenlog
+{
+    /**
+     * @brief Calculates a 32-bit FNV-1a hash over all format strings of the token table, which the
+     * device logs at start-up so that the decoder can detect a table built from other sources.
+     * @return The table hash.
+     */
+    uint32_t calculateTableHash()
+    {
+        uint32_t hash = FNV_OFFSET_BASIS;
+
+        for (const char *format : LOG_TOKEN_FORMATS)
+        {
+            size_t i = 0;
+
+            do
+            {
+                hash = (hash ^ static_cast<uint8_t>(format[i])) * FNV_PRIME;
+            } while (format[i++] != '\0');
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief Expands a format string of the token table with its arguments (see project_tokenlog.h
+     * for the conversions). Missing arguments expand as 0.
+     * @param buffer Pointer to the buffer where the null-terminated message will be stored; the
+     * message is truncated to buffer_size - 1 characters.
+     * @param buffer_size The size of the buffer in bytes (0 to only measure the message).
+     * @param format The null-terminated format string.
+     * @param arguments Pointer to the arguments.
+     * @param argument_count The number of arguments.
+     * @return The length of the complete message, which may exceed the buffer like with snprintf.
+     */
+    size_t expandMessage(char *buffer, size_t buffer_size, const char *format, const int32_t *arguments, uint8_t argument_count)
+    {
+        TextWriter writer = {buffer, buffer_size, 0};
+        uint8_t argument_index = 0;
+
+        for (size_t i = 0; format[i] != '\0'; i++)
+        {
+            if (format[i] != '%')
+            {
+                appendCharacter(&writer, format[i]);
+                continue;
+            }
+
+            if (format[++i] == '%')
+            {
+                appendCharacter(&writer, '%');
+                continue;
+            }
+
+            bool is_zero_padded = (format[i] == '0');
+            uint8_t width = 0;
+            uint8_t decimal_places = 0;
+
+            while (format[i] >= '0' && format[i] <= '9')
+            {
+                width = width * 10 + (format[i++] - '0');
+            }
+
+            if (format[i] == '.')
+            {
+                while (format[++i] >= '0' && format[i] <= '9')
+                {
+                    decimal_places = decimal_places * 10 + (format[i] - '0');
+                }
+            }
+
+            while (format[i] == 'l')
+            {
+                i++;
+            }
+
+            if (format[i] == '\0')
+            {
+                break;
+            }
+
+            int32_t value = (argument_index < argument_count) ? arguments[argument_index] : 0;
+            argument_index++;
+
+            char field[12];
+            uint8_t field_length;
+            bool is_negative = false;
+            uint32_t magnitude = static_cast<uint32_t>(value);
+
+            if ((format[i] == 'd' || format[i] == 'f') && value < 0)
+            {
+                is_negative = true;
+                magnitude = 0u - magnitude;
+            }
+
+            switch (format[i])
+            {
+            case 'f':
+                if (decimal_places > LOG_MAX_DECIMAL_PLACES)
+                {
+                    decimal_places = LOG_MAX_DECIMAL_PLACES;
+                }
+                field_length = formatFixedPointField(field, magnitude, decimal_places);
+                break;
+
+            case 'x':
+            case 'X':
+                field_length = formatDigits(field, magnitude, 16, format[i] == 'X');
+                break;
+
+            default:
+                field_length = formatDigits(field, magnitude, 10, false);
+                break;
+            }
+
+            appendField(&writer, field, field_length, is_negative, width, is_zero_padded);
+        }
+
+        if (buffer_size > 0)
+        {
+            buffer[(writer.length < buffer_size) ? writer.length : buffer_size - 1] = '\0';
+        }
+
+        return writer.length;
+    }
+
+    /**
+     * @brief Encodes a log frame: the frame start, the token, and one zigzag-coded varint per argument.
+     * @param buffer Pointer to a buffer of at least LOG_MAX_FRAME_SIZE bytes where the frame will be stored.
+     * @param token The token of the message.
+     * @param arguments Pointer to the arguments.
+     * @param argument_count The number of arguments (at most LOG_MAX_ARGUMENTS, further ones are ignored).
+     * @return The length of the frame in bytes.
+     */
+    size_t encodeFrame(uint8_t *buffer, LogToken token, const int32_t *arguments, uint8_t argument_count)
+    {
+        size_t length = 0;
+
+        buffer[length++] = LOG_FRAME_START;
+        buffer[length++] = static_cast<uint8_t>(token);
+
+        if (argument_count > LOG_MAX_ARGUMENTS)
+        {
+            argument_count = LOG_MAX_ARGUMENTS;
+        }
+
+        for (uint8_t i = 0; i < argument_count; i++)
+        {
+            // Zigzag coding keeps small negative values short: 0, -1, 1, -2, ... map to 0, 1, 2, 3, ...
+            uint32_t value = (static_cast<uint32_t>(arguments[i]) << 1) ^ static_cast<uint32_t>(arguments[i] >> 31);
+
+            while (value >= 0x80)
+            {
+                buffer[length++] = static_cast<uint8_t>(value) | 0x80;
+                value >>= 7;
+            }
+
+            buffer[length++] = static_cast<uint8_t>(value);
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief Decodes a log frame. The number of arguments follows from the format string of the token.
+     * @param frame Pointer to the received bytes, starting with the frame start.
+     * @param length The number of received bytes.
+     * @param token Pointer to a variable where the token will be stored.
+     * @param arguments Pointer to an array of LOG_MAX_ARGUMENTS values where the arguments will be stored.
+     * @param argument_count Pointer to a variable where the number of arguments will be stored.
+     * @return The length of the frame in bytes, or 0 if the frame is invalid or not yet complete.
+     */
+    size_t decodeFrame(const uint8_t *frame, size_t length, LogToken *token, int32_t *arguments, uint8_t *argument_count)
+    {
+        if (length < 2 || frame[0] != LOG_FRAME_START || frame[1] >= static_cast<uint8_t>(LogToken::Count))
+        {
+            return 0;
+        }
+
+        *token = static_cast<LogToken>(frame[1]);
+        *argument_count = LOG_TOKEN_ARGUMENT_COUNTS[frame[1]];
+
+        size_t offset = 2;
+
+        for (uint8_t i = 0; i < *argument_count; i++)
+        {
+            uint32_t value = 0;
+            uint8_t byte_count = 0;
+
+            do
+            {
+                if (offset == length || byte_count == LOG_MAX_VARINT_SIZE)
+                {
+                    return 0;
+                }
+
+                value |= static_cast<uint32_t>(frame[offset] & 0x7F) << (7 * byte_count++);
+            } while (frame[offset++] & 0x80);
+
+            arguments[i] = static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+        }
+
+        return offset;
+    }
+}
@@ -5,16 +5,74 @@
  * ------------------------------------------------------------------------------------------------
  */
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "stm32f4xx_hal.h"
 
 #include "project_utility.h"
+#include "UARTLogger.h"
 
-// Buffer size
+// Buffer size (also the truncation limit of status messages and of formatted messages sent without a UARTLogger)
 constexpr size_t UART_BUFFER_SIZE = 64;
 
+// Fraction bits of a temperature in Q8.8 format (1/256C per LSB)
+constexpr int Q8_8_FRACTION_BITS = 8;
+
+namespace
+{
+    // Encoding of the messages of the token table
+    LogEncoding current_log_encoding = LogEncoding::Text;
+
+    // Runtime log filter: the levels and categories of the token table that are logged
+    uint8_t current_log_level_mask = LOG_LEVEL_MASK_ALL;
+    uint8_t current_log_category_mask = LOG_CATEGORY_MASK_ALL;
+
+    // Format string and arguments of a message of the token table, expanded by expandTokenMessage
+    struct TokenMessage
+    {
+        const char *format;
+        const int32_t *arguments;
+        uint8_t argument_count;
+    };
+
+    /**
+     * @brief Expands a message of the token table, as the UARTMessageFormatter of
+     * UARTLogger::writeFormatted.
+     * @param buffer Pointer to the buffer where the message will be stored.
+     * @param buffer_size The size of the buffer in bytes.
+     * @param context Pointer to the TokenMessage.
+     * @return The length of the complete message.
+     */
+    int expandTokenMessage(char *buffer, size_t buffer_size, void *context)
+    {
+        const TokenMessage *message = static_cast<const TokenMessage *>(context);
+
+        return tokenlog::expandMessage(buffer, buffer_size, message->format, message->arguments, message->argument_count);
+    }
+
+    /**
+     * @brief Transmits a message of known length via UART, through the UARTLogger registered for the
+     * UART if there is one, otherwise blocking until the message has been sent.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     * @param message Pointer to the message.
+     * @param length The number of bytes of the message.
+     */
+    void transmitMessage(UART_HandleTypeDef *uart_handle, const char *message, size_t length)
+    {
+        UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+        if (uart_logger != nullptr)
+        {
+            uart_logger->write(reinterpret_cast<const uint8_t *>(message), length);
+            return;
+        }
+
+        HAL_UART_Transmit(uart_handle, (uint8_t *)message, length, HAL_MAX_DELAY);
+    }
+}
+
 namespace utility
 {
     /**
@@ -38,7 +96,9 @@ namespace utility
     }
 
     /**
-     * @brief Transmits a message via UART.
+     * @brief Transmits a message via UART. If a UARTLogger is registered for the UART, the message is
+     * only copied into its ring buffer and sent via DMA in the background; otherwise the call blocks
+     * until the message has been sent.
      * @param uart_handle Pointer to the UART handle used for transmission.
      * @param message The null-terminated error message to transmit.
      */
@@ -46,31 +106,188 @@ namespace utility
     {
         if (uart_handle && message)
         {
-            HAL_UART_Transmit(uart_handle, (uint8_t *)message, strlen(message), HAL_MAX_DELAY);
+            transmitMessage(uart_handle, message, strlen(message));
         }
     }
 
     /**
-     * @brief Logs a status message via UART.
+     * @brief Logs a status message via UART, truncated to UART_BUFFER_SIZE - 1 characters. The message
+     * is sent from where it is, without a copy.
      * @param uart_handle Pointer to the UART handle used for transmission.
      * @param status_message The null-terminated status message to transmit.
      */
     void logStatusMessage(UART_HandleTypeDef *uart_handle, char *status_message)
     {
-        char uart_buffer[UART_BUFFER_SIZE];
-        size_t message_length = strlen(status_message);
+        if (uart_handle && status_message)
+        {
+            transmitMessage(uart_handle, status_message, strnlen(status_message, UART_BUFFER_SIZE - 1));
+        }
+    }
 
-        if (message_length >= sizeof(uart_buffer))
+    /**
+     * @brief Formats and logs a message via UART. If a UARTLogger is registered for the UART, the
+     * message is formatted directly into its ring buffer (up to UART_LOGGER_MAX_MESSAGE_LENGTH - 1
+     * characters) and sent via DMA in the background; otherwise it is formatted into a stack buffer,
+     * truncated to UART_BUFFER_SIZE - 1 characters, and the call blocks until it has been sent.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     * @param format The printf-style format string, followed by its arguments.
+     */
+    void logFormattedMessage(UART_HandleTypeDef *uart_handle, const char *format, ...)
+    {
+        if (uart_handle == nullptr || format == nullptr)
         {
-            strncpy(uart_buffer, status_message, sizeof(uart_buffer) - 1);
-            uart_buffer[sizeof(uart_buffer) - 1] = '\0';
+            return;
+        }
+
+        va_list arguments;
+        va_start(arguments, format);
+
+        UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+        if (uart_logger != nullptr)
+        {
+            uart_logger->writeFormatted(format, arguments);
         }
         else
         {
-            strcpy(uart_buffer, status_message);
+            char uart_buffer[UART_BUFFER_SIZE];
+            int message_length = vsnprintf(uart_buffer, sizeof(uart_buffer), format, arguments);
+
+            if (message_length > 0)
+            {
+                size_t length = (static_cast<size_t>(message_length) < sizeof(uart_buffer)) ? message_length : sizeof(uart_buffer) - 1;
+                HAL_UART_Transmit(uart_handle, (uint8_t *)uart_buffer, length, HAL_MAX_DELAY);
+            }
         }
 
-        logMessage(uart_handle, uart_buffer);
+        va_end(arguments);
+    }
+
+    /**
+     * @brief Selects how the messages of the token table are sent: expanded to text on the device, or
+     * as compact log frames that the host-side decoder (Tools/log_decoder.cpp) expands.
+     * @param log_encoding The log encoding, see LogEncoding.
+     */
+    void setLogEncoding(LogEncoding log_encoding)
+    {
+        current_log_encoding = log_encoding;
+    }
+
+    /**
+     * @brief Selects the levels of the token table messages that are logged, on top of the
+     * compile-time filter. Disabled messages are dropped before they are formatted.
+     * @param level_mask Bit n enables LogLevel n, see tokenlog::getLevelMask.
+     */
+    void setLogLevelMask(uint8_t level_mask)
+    {
+        current_log_level_mask = level_mask;
+    }
+
+    /**
+     * @brief Retrieves the levels of the token table messages that are logged.
+     * @return The level mask, bit n for LogLevel n.
+     */
+    uint8_t getLogLevelMask()
+    {
+        return current_log_level_mask;
+    }
+
+    /**
+     * @brief Selects the categories of the token table messages that are logged, on top of the
+     * compile-time filter. Disabled messages are dropped before they are formatted.
+     * @param category_mask Bit n enables LogCategory n.
+     */
+    void setLogCategoryMask(uint8_t category_mask)
+    {
+        current_log_category_mask = category_mask;
+    }
+
+    /**
+     * @brief Checks whether a message of the token table passes the compile-time and the runtime log filter.
+     * @param token The token of the message.
+     * @return True if the message is logged, false otherwise.
+     */
+    bool isLogEnabled(LogToken token)
+    {
+        uint8_t index = static_cast<uint8_t>(token);
+
+        return tokenlog::isTokenCompiled(token) &&
+               (current_log_level_mask & (1 << static_cast<uint8_t>(LOG_TOKEN_LEVELS[index]))) &&
+               (current_log_category_mask & (1 << static_cast<uint8_t>(LOG_TOKEN_CATEGORIES[index])));
+    }
+
+    /**
+     * @brief Logs a message of the token table via UART. In the text encoding the message is expanded
+     * directly into the ring buffer of the UARTLogger (or into a stack buffer, truncated to
+     * UART_BUFFER_SIZE - 1 characters, without one); in the tokenized encoding only its log frame is
+     * sent.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     * @param token The token of the message.
+     * @param arguments Pointer to the arguments of the format string.
+     * @param argument_count The number of arguments.
+     */
+    void logTokenMessage(UART_HandleTypeDef *uart_handle, LogToken token, const int32_t *arguments, uint8_t argument_count)
+    {
+        if (uart_handle == nullptr || token >= LogToken::Count || !isLogEnabled(token))
+        {
+            return;
+        }
+
+        if (current_log_encoding == LogEncoding::Tokenized)
+        {
+            uint8_t frame[LOG_MAX_FRAME_SIZE];
+            size_t frame_length = tokenlog::encodeFrame(frame, token, arguments, argument_count);
+            UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+            if (uart_logger != nullptr)
+            {
+                uart_logger->writeFrame(frame, frame_length);
+                return;
+            }
+
+            HAL_UART_Transmit(uart_handle, frame, frame_length, HAL_MAX_DELAY);
+            return;
+        }
+
+        TokenMessage message = {LOG_TOKEN_FORMATS[static_cast<uint8_t>(token)], arguments, argument_count};
+        UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+        if (uart_logger != nullptr)
+        {
+            uart_logger->writeFormatted(expandTokenMessage, &message);
+            return;
+        }
+
+        char uart_buffer[UART_BUFFER_SIZE];
+        size_t message_length = expandTokenMessage(uart_buffer, sizeof(uart_buffer), &message);
+        size_t length = (message_length < sizeof(uart_buffer)) ? message_length : sizeof(uart_buffer) - 1;
+        HAL_UART_Transmit(uart_handle, (uint8_t *)uart_buffer, length, HAL_MAX_DELAY);
+    }
+
+    /**
+     * @brief Sends a binary telemetry packet via UART as one frame, which the UART logger either
+     * buffers as a whole or drops, so that the host never sees a partial packet.
+     * @param uart_handle Pointer to the UART handle used for transmission.
+     * @param sample The contents of the packet.
+     */
+    void logTelemetrySample(UART_HandleTypeDef *uart_handle, const TelemetrySample &sample)
+    {
+        if (uart_handle == nullptr)
+        {
+            return;
+        }
+
+        uint8_t frame[TELEMETRY_FRAME_SIZE];
+        size_t frame_length = telemetry::encodeFrame(sample, frame);
+        UARTLogger *uart_logger = UARTLogger::getInstance(uart_handle);
+
+        if (uart_logger != nullptr)
+        {
+            uart_logger->writeFrame(frame, frame_length);
+            return;
+        }
+
+        HAL_UART_Transmit(uart_handle, frame, frame_length, HAL_MAX_DELAY);
     }
 
     /**
@@ -99,4 +316,114 @@ namespace utility
         snprintf(uart_buffer, sizeof(uart_buffer), "Scan complete.\r\n");
         logMessage(uart_handle, uart_buffer);
     }
+
+    /**
+     * @brief Enables the DWT cycle counter used for microsecond timing measurements.
+     */
+    void enableCycleCounter()
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    /**
+     * @brief Retrieves the current value of the DWT cycle counter.
+     * @return The number of CPU cycles elapsed since the counter was enabled (wraps every ~51 s at 84 MHz).
+     */
+    uint32_t getCycleCount()
+    {
+        return DWT->CYCCNT;
+    }
+
+    /**
+     * @brief Converts a number of CPU cycles to microseconds based on the current core clock.
+     * @param cycles The number of CPU cycles.
+     * @return The equivalent duration in microseconds.
+     */
+    uint32_t convertCyclesToMicroseconds(uint32_t cycles)
+    {
+        return cycles / (SystemCoreClock / 1000000);
+    }
+
+    /**
+     * @brief Converts a temperature in Q8.8 format to hundredths of a degree Celsius without
+     * floating-point arithmetic, rounded to the nearest hundredth with ties to even like printf
+     * (e.g. 23.4375C to 2344 and 23.125C to 2312).
+     * @param q8_8_temperature The temperature in units of 1/256C.
+     * @return The temperature in units of 0.01C.
+     */
+    int16_t convertQ8_8ToCentiCelsius(int16_t q8_8_temperature)
+    {
+        int32_t scaled_temperature = q8_8_temperature * 100;
+        constexpr int32_t half = 1 << (Q8_8_FRACTION_BITS - 1);
+
+        // The arithmetic shift rounds towards negative infinity; the remainder decides the rounding
+        int32_t centi_celsius_temperature = scaled_temperature >> Q8_8_FRACTION_BITS;
+        int32_t remainder = scaled_temperature & ((1 << Q8_8_FRACTION_BITS) - 1);
+
+        if (remainder > half || (remainder == half && (centi_celsius_temperature & 1)))
+        {
+            centi_celsius_temperature++;
+        }
+
+        return static_cast<int16_t>(centi_celsius_temperature);
+    }
+
+    /**
+     * @brief Formats a fixed-point value with the given number of decimal places (e.g. 2325 with two
+     * decimal places as "23.25") using integer arithmetic only, so no floating-point printf is needed.
+     * @param buffer Pointer to the buffer where the null-terminated text will be stored.
+     * @param buffer_size The size of the buffer in bytes.
+     * @param value The value in units of 10^-decimal_places.
+     * @param decimal_places The number of digits after the decimal point (0 to 9).
+     * @return The length of the text, or 0 if it does not fit into the buffer.
+     */
+    size_t formatFixedPoint(char *buffer, size_t buffer_size, int32_t value, uint8_t decimal_places)
+    {
+        char digits[10];
+        size_t digit_count = 0;
+        uint32_t magnitude = (value < 0) ? 0 - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+
+        if (buffer == nullptr || buffer_size == 0 || decimal_places > 9)
+        {
+            return 0;
+        }
+
+        // Digits in reverse order, with at least one digit before the decimal point
+        do
+        {
+            digits[digit_count++] = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while (magnitude > 0 || digit_count <= decimal_places);
+
+        size_t length = (value < 0) + digit_count + (decimal_places > 0);
+
+        if (length >= buffer_size)
+        {
+            buffer[0] = '\0';
+            return 0;
+        }
+
+        size_t offset = 0;
+
+        if (value < 0)
+        {
+            buffer[offset++] = '-';
+        }
+
+        while (digit_count > 0)
+        {
+            if (digit_count == decimal_places)
+            {
+                buffer[offset++] = '.';
+            }
+
+            buffer[offset++] = digits[--digit_count];
+        }
+
+        buffer[offset] = '\0';
+
+        return offset;
+    }
 }
@@ -0,0 +1,106 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file log_decoder.cpp
+ * @brief Host-side decoder that expands the log frames of the tokenized log mode back to text.
+ *
+ * Built from the token table of the firmware sources, so that both always share the same table:
+ *     g++ -std=c++17 -O2 -IProject/Inc Tools/log_decoder.cpp Project/Src/project_tokenlog.cpp -o log_decoder
+ * Usage (115200 baud, 8N1, raw mode):
+ *     stty -F /dev/ttyACM0 115200 raw && ./log_decoder /dev/ttyACM0
+ *     ./log_decoder capture.bin > capture.txt
+ * Text between the frames (e.g. benchmark results) is passed through unchanged.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+
+#include "project_tokenlog.h"
+
+/**
+ * @brief Expands a complete log frame and writes the message to the standard output. A table hash
+ * frame that does not match the table of this decoder is reported on the standard error output.
+ * @param frame Pointer to the bytes of the frame.
+ * @param length The number of bytes of the frame.
+ * @return The length of the frame in bytes, or 0 if the frame is not yet complete.
+ */
+static size_t expandFrame(const uint8_t *frame, size_t length)
+{
+    LogToken token;
+    int32_t arguments[LOG_MAX_ARGUMENTS];
+    uint8_t argument_count;
+    size_t frame_length = tokenlog::decodeFrame(frame, length, &token, arguments, &argument_count);
+
+    if (frame_length == 0)
+    {
+        return 0;
+    }
+
+    char message[256];
+    tokenlog::expandMessage(message, sizeof(message), LOG_TOKEN_FORMATS[static_cast<uint8_t>(token)], arguments, argument_count);
+    fputs(message, stdout);
+
+    if (token == LogToken::TableHash && static_cast<uint32_t>(arguments[0]) != tokenlog::calculateTableHash())
+    {
+        fprintf(stderr, "Warning: the token table of the firmware (0x%08X) differs from the decoder's (0x%08X); "
+                        "rebuild the decoder from the firmware sources.\n",
+                static_cast<unsigned>(arguments[0]), static_cast<unsigned>(tokenlog::calculateTableHash()));
+    }
+
+    return frame_length;
+}
+
+int main(int argc, char **argv)
+{
+    FILE *input = stdin;
+
+    if (argc > 1)
+    {
+        input = fopen(argv[1], "rb");
+
+        if (input == nullptr)
+        {
+            fprintf(stderr, "Error: Failed to open %s!\n", argv[1]);
+            return 1;
+        }
+    }
+
+    uint8_t frame[LOG_MAX_FRAME_SIZE];
+    size_t frame_length = 0;
+    int character;
+
+    while ((character = fgetc(input)) != EOF)
+    {
+        if (frame_length == 0 && character != LOG_FRAME_START)
+        {
+            putchar(character);
+            continue;
+        }
+
+        frame[frame_length++] = static_cast<uint8_t>(character);
+
+        bool is_token_valid = frame_length < 2 || frame[1] < static_cast<uint8_t>(LogToken::Count);
+
+        if (is_token_valid && frame_length < 2)
+        {
+            continue;
+        }
+
+        if (is_token_valid && expandFrame(frame, frame_length) > 0)
+        {
+            frame_length = 0;
+        }
+        else if (!is_token_valid || frame_length == LOG_MAX_FRAME_SIZE)
+        {
+            // Lost bytes (e.g. dropped by the overflow policy of the UART logger); resume with the next frame start
+            fputs("[invalid log frame]\n", stdout);
+            frame_length = 0;
+        }
+    }
+
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file telemetry_dump.cpp
+ * @brief Host-side tool that converts the binary telemetry stream to CSV.
+ *
+ * Built from the packet definition of the firmware sources:
+ *     g++ -std=c++17 -O2 -IProject/Inc -ITools Tools/telemetry_dump.cpp Tools/telemetry_parser.cpp \
+ *         Project/Src/project_telemetry.cpp Project/Src/project_codec.cpp -o telemetry_dump
+ * Usage (115200 baud, 8N1, raw mode; 'b' switches the device to binary telemetry, 't' back to text):
+ *     stty -F /dev/ttyACM0 115200 raw && printf b > /dev/ttyACM0 && ./telemetry_dump /dev/ttyACM0 > samples.csv
+ *     ./telemetry_dump capture.bin > samples.csv
+ * One CSV line per packet goes to the standard output; text messages sent between the packets, corrupt
+ * frames, and the packet counters at the end of the stream go to the standard error output.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+
+#include "telemetry_parser.h"
+
+/**
+ * @brief Writes the result of a completed frame: a CSV line for a packet, the text of a message, or
+ * a notice of a corrupt frame.
+ * @param parser The parser that completed the frame.
+ * @param result The result of the frame.
+ */
+static void printFrame(const TelemetryParser &parser, TelemetryParseResult result)
+{
+    switch (result)
+    {
+    case TelemetryParseResult::Sample:
+    {
+        const TelemetrySample &sample = parser.getSample();
+        printf("%u,%u,0x%02X,0x%04X,%.4f,%u,0x%02X\n", sample.sequence, static_cast<unsigned>(sample.timestamp_ms),
+               sample.sensor_id, sample.raw_sample, static_cast<int16_t>(sample.raw_sample) / 256.0,
+               9 + (sample.status_flags & TELEMETRY_FLAG_RESOLUTION_MASK), sample.status_flags);
+        break;
+    }
+
+    case TelemetryParseResult::Text:
+    {
+        size_t length;
+        const char *text = parser.getText(&length);
+        fwrite(text, 1, length, stderr);
+        break;
+    }
+
+    case TelemetryParseResult::Corrupt:
+        fputs("[corrupt telemetry frame]\n", stderr);
+        break;
+
+    default:
+        break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *input = stdin;
+
+    if (argc > 1)
+    {
+        input = fopen(argv[1], "rb");
+
+        if (input == nullptr)
+        {
+            fprintf(stderr, "Error: Failed to open %s!\n", argv[1]);
+            return 1;
+        }
+    }
+
+    TelemetryParser parser;
+    int character;
+
+    puts("sequence,timestamp_ms,sensor,raw,temperature_c,resolution_bits,flags");
+
+    while ((character = fgetc(input)) != EOF)
+    {
+        printFrame(parser, parser.feed(static_cast<uint8_t>(character)));
+    }
+
+    printFrame(parser, parser.finish());
+
+    const TelemetryParserStats &stats = parser.getStats();
+    fprintf(stderr, "Packets: %u received, %u lost, %u corrupt frames, %u text messages, %u device resets.\n",
+            static_cast<unsigned>(stats.packet_count), static_cast<unsigned>(stats.lost_packet_count),
+            static_cast<unsigned>(stats.corrupt_frame_count), static_cast<unsigned>(stats.text_frame_count),
+            static_cast<unsigned>(stats.reset_count));
+
+    if (input != stdin)
+    {
+        fclose(input);
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file telemetry_parser.cpp
+ * @brief Implementation file for the TelemetryParser class, the host-side parser of the binary telemetry.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "telemetry_parser.h"
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Public_Methods Public Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Constructor for the TelemetryParser class.
+ */
+TelemetryParser::TelemetryParser()
+{
+    this->frame_length = 0;
+    this->text_length = 0;
+    this->sample = {};
+    this->is_sequence_known = false;
+    this->next_sequence = 0;
+    this->last_timestamp_ms = 0;
+    this->stats = {};
+}
+
+/**
+ * @brief Feeds a received byte to the parser. A frame ends at each delimiter; a text run that
+ * exceeds TELEMETRY_PARSER_MAX_FRAME_LENGTH is returned early.
+ * @param byte The received byte.
+ * @return The result of the frame the byte completed, or None.
+ */
+TelemetryParseResult TelemetryParser::feed(uint8_t byte)
+{
+    if (byte == TELEMETRY_FRAME_DELIMITER)
+    {
+        return this->parseFrame();
+    }
+
+    this->frame[this->frame_length++] = byte;
+
+    if (this->frame_length == TELEMETRY_PARSER_MAX_FRAME_LENGTH)
+    {
+        return this->parseFrame();
+    }
+
+    return TelemetryParseResult::None;
+}
+
+/**
+ * @brief Parses the bytes received after the last delimiter at the end of the stream.
+ * @return The result of the unterminated frame, or None if there is none.
+ */
+TelemetryParseResult TelemetryParser::finish()
+{
+    return this->parseFrame();
+}
+
+/**
+ * @brief Retrieves the contents of the last valid packet.
+ * @return The contents of the packet.
+ */
+const TelemetrySample &TelemetryParser::getSample() const
+{
+    return this->sample;
+}
+
+/**
+ * @brief Retrieves the last text message, which is valid until the next byte is fed.
+ * @param length Pointer to a variable where the length of the text will be stored (not null-terminated).
+ * @return Pointer to the characters of the text.
+ */
+const char *TelemetryParser::getText(size_t *length) const
+{
+    *length = this->text_length;
+    return reinterpret_cast<const char *>(this->frame);
+}
+
+/**
+ * @brief Retrieves the counters of the parsed stream.
+ * @return The counters.
+ */
+const TelemetryParserStats &TelemetryParser::getStats() const
+{
+    return this->stats;
+}
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @section Private_Methods Private Methods
+ * ------------------------------------------------------------------------------------------------
+ */
+
+/**
+ * @brief Classifies the collected frame: a packet that passes the length, type, and CRC checks, a
+ * text message (all device messages end with a line feed), or a corrupt frame. Counts the packets
+ * missing from the sequence numbers, which includes corrupt ones. A timestamp below the previous
+ * one marks a device reset, which restarts the sequence numbers at 0; the sequence is resynchronized
+ * at such a packet instead of counting the jump as lost packets.
+ * @return The result of the frame.
+ */
+TelemetryParseResult TelemetryParser::parseFrame()
+{
+    size_t length = this->frame_length;
+
+    this->frame_length = 0;
+    this->text_length = 0;
+
+    if (length == 0)
+    {
+        return TelemetryParseResult::None;
+    }
+
+    if (telemetry::decodePacket(this->frame, length, &this->sample))
+    {
+        if (this->is_sequence_known && this->sample.timestamp_ms < this->last_timestamp_ms)
+        {
+            this->stats.reset_count++;
+        }
+        else if (this->is_sequence_known)
+        {
+            this->stats.lost_packet_count += static_cast<uint16_t>(this->sample.sequence - this->next_sequence);
+        }
+
+        this->is_sequence_known = true;
+        this->next_sequence = this->sample.sequence + 1;
+        this->last_timestamp_ms = this->sample.timestamp_ms;
+        this->stats.packet_count++;
+        return TelemetryParseResult::Sample;
+    }
+
+    if (this->frame[length - 1] == '\n' || length == TELEMETRY_PARSER_MAX_FRAME_LENGTH)
+    {
+        this->text_length = length;
+        this->stats.text_frame_count++;
+        return TelemetryParseResult::Text;
+    }
+
+    this->stats.corrupt_frame_count++;
+    return TelemetryParseResult::Corrupt;
+}
@@ -0,0 +1,67 @@
+/**
+ * ------------------------------------------------------------------------------------------------
+ * @file telemetry_parser.h
+ * @brief Header file for the TelemetryParser class, the host-side parser of the binary telemetry.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "project_telemetry.h"
+
+// Longest run of bytes between two delimiters that is collected; longer text runs are returned in pieces
+constexpr size_t TELEMETRY_PARSER_MAX_FRAME_LENGTH = 256;
+
+// Result of feeding a byte to the parser
+//   None    The byte was collected, or ended an empty frame
+//   Sample  A valid packet was completed; see getSample
+//   Text    A text message sent between the packets was completed; see getText
+//   Corrupt A frame that is neither a valid packet nor text was discarded (lost bytes or a CRC error)
+enum class TelemetryParseResult : uint8_t
+{
+    None,
+    Sample,
+    Text,
+    Corrupt
+};
+
+// Counters of the parsed stream
+struct TelemetryParserStats
+{
+    uint32_t packet_count;
+    uint32_t lost_packet_count;
+    uint32_t corrupt_frame_count;
+    uint32_t text_frame_count;
+    uint32_t reset_count;
+};
+
+class TelemetryParser
+{
+public:
+    // Constructor
+    TelemetryParser();
+
+    // Public methods
+    TelemetryParseResult feed(uint8_t byte);
+    TelemetryParseResult finish();
+    const TelemetrySample &getSample() const;
+    const char *getText(size_t *length) const;
+    const TelemetryParserStats &getStats() const;
+
+private:
+    // Private helper methods
+    TelemetryParseResult parseFrame();
+
+    // Data members
+    uint8_t frame[TELEMETRY_PARSER_MAX_FRAME_LENGTH];
+    size_t frame_length;
+    size_t text_length;
+    TelemetrySample sample;
+    bool is_sequence_known;
+    uint16_t next_sequence;
+    uint32_t last_timestamp_ms;
+    TelemetryParserStats stats;
+};